@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_checksum.h"
+#include "ibn_crc32.h"
+
+#include <bn_array.h>
+#include <bn_core.h>
+#include <bn_log.h>
+#include <bn_sprite_ptr.h>
+#include <bn_sprite_text_generator.h>
+#include <bn_string.h>
+#include <bn_timer.h>
+#include <bn_timers.h>
+#include <bn_vector.h>
+
+#include "common_variable_8x8_sprite_font.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Measures the crc32 kernels and the other `sram_rw` checksums in CPU cycles per byte, from 16 bytes to 32 KiB.
+//
+// `crc32_fast` uses the fastest kernel on the GBA, so check that it matches the fastest one here.
+// The full results are logged, and the screen shows some of the sizes.
+//
+// Error detection strength of the checksums doesn't depend on the platform,
+// so it's measured by `make -C host run FILTER=detection` instead.
+
+namespace
+{
+
+constexpr int CYCLES_PER_FRAME = 280896;
+
+constexpr int MAX_BYTES = 32 * 1024;
+constexpr int MIN_MEASURED_BYTES = 16 * 1024;
+
+using crc32_fn = std::uint32_t (*)(const void*, std::size_t, std::uint32_t);
+
+struct crc32_kernel
+{
+    bn::string_view name;
+    crc32_fn fn;
+    bool crc32 = true;
+};
+
+// Other checksums, in the same signature as the crc32 kernels
+template <ibn::checksum_kind Kind>
+auto checksum(const void* data, std::size_t length, std::uint32_t) -> std::uint32_t
+{
+    return ibn::checksum_stream(Kind).update(data, length).value();
+}
+
+constexpr crc32_kernel KERNELS[] = {
+    {"bitwise", ibn::crc32_bitwise},
+    {"halfbyte", ibn::crc32_halfbyte},
+    {"1byte", ibn::crc32_1byte},
+    {"4bytes", ibn::crc32_4bytes},
+    {"4x4bytes_arm", ibn::crc32_4x4bytes_arm},
+    {"fast", ibn::crc32_fast},
+    {"fletcher32", checksum<ibn::checksum_kind::FLETCHER32>, false},
+    {"adler32", checksum<ibn::checksum_kind::ADLER32>, false},
+    {"xxhash32", checksum<ibn::checksum_kind::XXHASH32>, false},
+};
+
+constexpr int KERNELS_COUNT = sizeof(KERNELS) / sizeof(KERNELS[0]);
+
+constexpr int SIZES[] = {16, 64, 256, 1024, 4 * 1024, 16 * 1024, 32 * 1024};
+constexpr int SIZES_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+
+// Sizes shown on the screen, as indexes of `SIZES`
+constexpr int SHOWN_SIZES[] = {0, 2, 4, 6};
+
+// Save data is usually serialized to a buffer in EWRAM
+alignas(4) BN_DATA_EWRAM_BSS std::uint8_t data[MAX_BYTES];
+
+auto ticks_to_cycles(int ticks) -> std::uint32_t
+{
+    return std::uint32_t((std::int64_t(ticks) * CYCLES_PER_FRAME) / bn::timers::ticks_per_frame());
+}
+
+// Returns the cycles per 10 bytes, to show one decimal place
+auto measure(const crc32_kernel& kernel, int size) -> std::uint32_t
+{
+    // Repeat the small sizes, so that the timer granularity doesn't matter
+    const int repeats = (size < MIN_MEASURED_BYTES) ? MIN_MEASURED_BYTES / size : 1;
+
+    std::uint32_t crc32 = 0;
+    bn::timer timer;
+
+    for (int repeat = 0; repeat < repeats; ++repeat)
+        crc32 = kernel.fn(data, size, crc32);
+
+    const std::uint32_t cycles = ticks_to_cycles(timer.elapsed_ticks());
+    BN_LOG(kernel.name, "/", size, ": ", cycles / repeats, " cycles (checksum: ", crc32, ")");
+
+    return std::uint32_t(std::int64_t(cycles) * 10 / (std::int64_t(size) * repeats));
+}
+
+} // namespace
+
+int main()
+{
+    bn::core::init();
+
+    bn::sprite_text_generator text_generator(common::variable_8x8_sprite_font);
+
+    for (int i = 0; i < MAX_BYTES; ++i)
+        data[i] = std::uint8_t(i * 2654435761u >> 24);
+
+    // Every crc32 kernel must agree with each other
+    const std::uint32_t expected_crc32 = ibn::crc32_bitwise(data, MAX_BYTES, 0);
+    for (const crc32_kernel& kernel : KERNELS)
+        if (kernel.crc32)
+            BN_ASSERT(kernel.fn(data, MAX_BYTES, 0) == expected_crc32, "crc32 mismatch: ", kernel.name);
+
+    // Measure
+    bn::array<bn::array<std::uint32_t, SIZES_COUNT>, KERNELS_COUNT> cycles_per_10_bytes;
+    for (int kernel = 0; kernel < KERNELS_COUNT; ++kernel)
+        for (int size = 0; size < SIZES_COUNT; ++size)
+            cycles_per_10_bytes[kernel][size] = measure(KERNELS[kernel], SIZES[size]);
+
+    // Show the results
+    bn::vector<bn::sprite_ptr, 128> text_sprites;
+    text_generator.set_left_alignment();
+    text_generator.generate(-112, -76, "cycles/byte: 16B 256B 4KiB 32KiB", text_sprites);
+
+    for (int kernel = 0; kernel < KERNELS_COUNT; ++kernel)
+    {
+        bn::string<64> line;
+        bn::ostringstream stream(line);
+        stream << KERNELS[kernel].name << ":";
+
+        for (const int size : SHOWN_SIZES)
+        {
+            const std::uint32_t value = cycles_per_10_bytes[kernel][size];
+            stream << " " << value / 10 << "." << value % 10;
+        }
+
+        text_generator.generate(-112, -60 + kernel * 14, line, text_sprites);
+        BN_LOG(line);
+    }
+
+    while (true)
+        bn::core::update();
+}
@@ -0,0 +1,243 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_bit_stream.h"
+#include "ibn_crc32.h"
+#include "ibn_sprite_text_typewriter.h"
+#include "ibn_sram_rw.h"
+#include "ibn_transitions.h"
+
+#include <bn_array.h>
+#include <bn_core.h>
+#include <bn_display.h>
+#include <bn_log.h>
+#include <bn_sprite_ptr.h>
+#include <bn_sprite_text_generator.h>
+#include <bn_string.h>
+#include <bn_timer.h>
+#include <bn_timers.h>
+#include <bn_vector.h>
+
+#include "common_variable_8x8_sprite_font.h"
+
+#include <cstdint>
+
+// Measures the ibn hot paths in CPU cycles.
+//
+// Build & run this without `IWRAM=1` first, so that its results are saved to the SRAM.
+// Then, build & run this with `IWRAM=1` to see how many cycles are saved by placing them in IWRAM.
+
+namespace
+{
+
+constexpr int CYCLES_PER_FRAME = 280896;
+
+constexpr int WORDS_COUNT = 256;
+constexpr int CRC32_BYTES = 1024;
+constexpr int REPEATS = 16;
+constexpr int MEASURED_UPDATES = 64;
+
+constexpr bn::string_view TYPEWRITER_STR =
+    "The quick brown fox jumps over a lazy dog. THE QUICK BROWN FOX JUMPS OVER A LAZY DOG!";
+
+enum benchmark_id
+{
+    BIT_STREAM_WRITE,
+    BIT_STREAM_READ,
+    CRC32,
+    TRANSITIONS,
+    TYPEWRITER,
+
+    BENCHMARKS_COUNT
+};
+
+constexpr bn::array<bn::string_view, BENCHMARKS_COUNT> BENCHMARK_NAMES = {
+    "bit_stream write/word", "bit_stream read/word", "crc32_fast/1KiB", "transitions update", "typewriter update",
+};
+
+struct results
+{
+    bn::array<std::uint32_t, BENCHMARKS_COUNT> rom_cycles = {};
+    bn::array<std::uint32_t, BENCHMARKS_COUNT> iwram_cycles = {};
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        for (std::uint32_t cycles : rom_cycles)
+            measurer.write(cycles);
+        for (std::uint32_t cycles : iwram_cycles)
+            measurer.write(cycles);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        for (std::uint32_t cycles : rom_cycles)
+            writer.write(cycles);
+        for (std::uint32_t cycles : iwram_cycles)
+            writer.write(cycles);
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        for (std::uint32_t& cycles : rom_cycles)
+            reader.read(cycles);
+        for (std::uint32_t& cycles : iwram_cycles)
+            reader.read(cycles);
+    }
+};
+
+auto ticks_to_cycles(int ticks) -> std::uint32_t
+{
+    return std::uint32_t((std::int64_t(ticks) * CYCLES_PER_FRAME) / bn::timers::ticks_per_frame());
+}
+
+alignas(4) std::uint32_t words_buffer[WORDS_COUNT];
+alignas(4) std::uint8_t crc32_buffer[CRC32_BYTES];
+
+auto measure_bit_stream_write() -> std::uint32_t
+{
+    bn::timer timer;
+
+    for (int repeat = 0; repeat < REPEATS; ++repeat)
+    {
+        ibn::bit_stream_writer writer(words_buffer, WORDS_COUNT, sizeof(words_buffer));
+        for (int i = 0; i < WORDS_COUNT; ++i)
+            writer.write(std::uint32_t(i * 2654435761u));
+        writer.flush_final();
+    }
+
+    return ticks_to_cycles(timer.elapsed_ticks()) / (REPEATS * WORDS_COUNT);
+}
+
+auto measure_bit_stream_read() -> std::uint32_t
+{
+    std::uint32_t sum = 0;
+    bn::timer timer;
+
+    for (int repeat = 0; repeat < REPEATS; ++repeat)
+    {
+        ibn::bit_stream_reader reader(words_buffer, WORDS_COUNT, sizeof(words_buffer));
+        for (int i = 0; i < WORDS_COUNT; ++i)
+        {
+            std::uint32_t value;
+            reader.read(value);
+            sum += value;
+        }
+    }
+
+    const std::uint32_t result = ticks_to_cycles(timer.elapsed_ticks()) / (REPEATS * WORDS_COUNT);
+    BN_LOG("bit_stream read sum: ", sum);
+    return result;
+}
+
+auto measure_crc32() -> std::uint32_t
+{
+    for (int i = 0; i < CRC32_BYTES; ++i)
+        crc32_buffer[i] = std::uint8_t(i);
+
+    std::uint32_t crc32 = 0;
+    bn::timer timer;
+
+    for (int repeat = 0; repeat < REPEATS; ++repeat)
+        crc32 = ibn::crc32_fast(crc32_buffer, CRC32_BYTES, crc32);
+
+    const std::uint32_t result = ticks_to_cycles(timer.elapsed_ticks()) / REPEATS;
+    BN_LOG("crc32: ", crc32);
+    return result;
+}
+
+auto measure_transitions() -> std::uint32_t
+{
+    using kinds = ibn::transitions::kinds;
+
+    ibn::transitions transitions;
+    const kinds flags = kinds::FADE | kinds::SPRITES_MOSAIC | kinds::BGS_MOSAIC | kinds::BG_PALS_BRIGHTNESS |
+                        kinds::BG_PALS_GRAYSCALE | kinds::BG_PALS_HUE_SHIFT;
+    transitions.start(flags, MEASURED_UPDATES, 1);
+
+    int ticks = 0;
+    for (int update = 0; update < MEASURED_UPDATES; ++update)
+    {
+        bn::timer timer;
+        transitions.update();
+        ticks += timer.elapsed_ticks();
+
+        bn::core::update();
+    }
+
+    transitions.clear();
+    transitions.set_alpha(kinds::ALL, 0);
+    transitions.update();
+
+    return ticks_to_cycles(ticks) / MEASURED_UPDATES;
+}
+
+auto measure_typewriter(const bn::sprite_text_generator& text_generator) -> std::uint32_t
+{
+    bn::vector<bn::sprite_ptr, 32> sprites;
+    ibn::sprite_text_typewriter typewriter(text_generator);
+    typewriter.start(8, 8, TYPEWRITER_STR, sprites, 1, nullptr, bn::display::width() - 16, 10, 4);
+
+    int ticks = 0;
+    for (int update = 0; update < MEASURED_UPDATES; ++update)
+    {
+        bn::timer timer;
+        if (!typewriter.done())
+            typewriter.update();
+        ticks += timer.elapsed_ticks();
+
+        bn::core::update();
+    }
+
+    return ticks_to_cycles(ticks) / MEASURED_UPDATES;
+}
+
+} // namespace
+
+int main()
+{
+    bn::core::init();
+
+    bn::sprite_text_generator text_generator(common::variable_8x8_sprite_font);
+
+    // Load the results of the other build
+    ibn::sram_rw sram("IBNIW", 0, 256);
+    results saved;
+    sram.read(saved);
+
+    // Measure
+    bn::array<std::uint32_t, BENCHMARKS_COUNT> cycles;
+    cycles[BIT_STREAM_WRITE] = measure_bit_stream_write();
+    cycles[BIT_STREAM_READ] = measure_bit_stream_read();
+    cycles[CRC32] = measure_crc32();
+    cycles[TRANSITIONS] = measure_transitions();
+    cycles[TYPEWRITER] = measure_typewriter(text_generator);
+
+#if IBN_CFG_BIT_STREAM_IWRAM
+    saved.iwram_cycles = cycles;
+#else
+    saved.rom_cycles = cycles;
+#endif
+    sram.write(saved);
+
+    // Show the results
+    bn::vector<bn::sprite_ptr, 64> text_sprites;
+    text_generator.set_left_alignment();
+#if IBN_CFG_BIT_STREAM_IWRAM
+    text_generator.generate(-112, -72, "IWRAM build (cycles: ROM / IWRAM)", text_sprites);
+#else
+    text_generator.generate(-112, -72, "ROM build (cycles: ROM / IWRAM)", text_sprites);
+#endif
+
+    for (int id = 0; id < BENCHMARKS_COUNT; ++id)
+    {
+        bn::string<48> line;
+        bn::ostringstream stream(line);
+        stream << BENCHMARK_NAMES[id] << ": " << saved.rom_cycles[id] << " / " << saved.iwram_cycles[id];
+
+        text_generator.generate(-112, -48 + id * 16, line, text_sprites);
+        BN_LOG(line);
+    }
+
+    while (true)
+        bn::core::update();
+}
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_assert.h`.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace bn::assert
+{
+
+template <typename... Args>
+[[noreturn]] void show(const char* condition, const char* file, int line, const Args&... args)
+{
+    std::cerr << file << ':' << line << ": " << condition << '\n';
+    ((std::cerr << args), ...);
+    std::cerr << std::endl;
+    std::abort();
+}
+
+} // namespace bn::assert
+
+#define BN_ASSERT(condition, ...) \
+    do \
+    { \
+        if (!(condition)) [[unlikely]] \
+            bn::assert::show(#condition, __FILE__, __LINE__ __VA_OPT__(, ) __VA_ARGS__); \
+    } while (false)
+
+#define BN_BASIC_ASSERT(condition, ...) BN_ASSERT(condition __VA_OPT__(, ) __VA_ARGS__)
+
+#define BN_ERROR(...) bn::assert::show("error", __FILE__, __LINE__ __VA_OPT__(, ) __VA_ARGS__)
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_common.h`.
+// Memory placement attributes are meaningless on the host, so they're all no-op.
+
+#pragma once
+
+#include <cstdint>
+
+#define BN_CODE_IWRAM
+#define BN_CODE_EWRAM
+#define BN_DATA_EWRAM
+#define BN_DATA_EWRAM_BSS
+
+#define BN_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#define BN_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
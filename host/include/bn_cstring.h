@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_cstring.h`.
+
+#pragma once
+
+#include <cstring>
+
+namespace bn
+{
+
+inline void memcpy(void* destination, const void* source, int bytes)
+{
+    std::memcpy(destination, source, static_cast<std::size_t>(bytes));
+}
+
+inline void memset(void* destination, std::uint8_t value, int bytes)
+{
+    std::memset(destination, value, static_cast<std::size_t>(bytes));
+}
+
+inline void memclear(void* destination, int bytes)
+{
+    std::memset(destination, 0, static_cast<std::size_t>(bytes));
+}
+
+} // namespace bn
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_fixed.h`.
+// Only the raw data access is provided, as that's all the ibn core needs.
+
+#pragma once
+
+namespace bn
+{
+
+template <int Precision>
+class fixed_t
+{
+public:
+    constexpr fixed_t() = default;
+
+    constexpr fixed_t(int integer) : _data(integer << Precision)
+    {
+    }
+
+    [[nodiscard]] static constexpr fixed_t from_data(int data)
+    {
+        fixed_t result;
+        result._data = data;
+        return result;
+    }
+
+    [[nodiscard]] constexpr int data() const
+    {
+        return _data;
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(fixed_t a, fixed_t b) = default;
+
+private:
+    int _data = 0;
+};
+
+using fixed = fixed_t<12>;
+
+} // namespace bn
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_intrusive_list.h`.
+
+#pragma once
+
+#include "bn_assert.h"
+
+namespace bn
+{
+
+class intrusive_list_node_type
+{
+public:
+    intrusive_list_node_type() = default;
+
+private:
+    template <typename Type>
+    friend class intrusive_list;
+
+    intrusive_list_node_type* prev = nullptr;
+    intrusive_list_node_type* next = nullptr;
+};
+
+template <typename Type>
+class intrusive_list
+{
+public:
+    class iterator
+    {
+    public:
+        iterator() = default;
+
+        explicit iterator(intrusive_list_node_type* node) : _node(node)
+        {
+        }
+
+        iterator& operator++()
+        {
+            _node = _node->next;
+            return *this;
+        }
+
+        iterator& operator--()
+        {
+            _node = _node->prev;
+            return *this;
+        }
+
+        [[nodiscard]] Type& operator*() const
+        {
+            return static_cast<Type&>(*_node);
+        }
+
+        [[nodiscard]] Type* operator->() const
+        {
+            return static_cast<Type*>(_node);
+        }
+
+        [[nodiscard]] friend bool operator==(const iterator& a, const iterator& b) = default;
+
+    private:
+        friend class intrusive_list;
+
+        intrusive_list_node_type* _node = nullptr;
+    };
+
+    intrusive_list()
+    {
+        _first_node.next = &_last_node;
+        _last_node.prev = &_first_node;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    ~intrusive_list()
+    {
+        clear();
+    }
+
+    [[nodiscard]] int size() const
+    {
+        return _size;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] iterator begin()
+    {
+        return iterator(_first_node.next);
+    }
+
+    [[nodiscard]] iterator end()
+    {
+        return iterator(&_last_node);
+    }
+
+    [[nodiscard]] Type& front()
+    {
+        BN_BASIC_ASSERT(!empty(), "List is empty");
+        return static_cast<Type&>(*_first_node.next);
+    }
+
+    [[nodiscard]] Type& back()
+    {
+        BN_BASIC_ASSERT(!empty(), "List is empty");
+        return static_cast<Type&>(*_last_node.prev);
+    }
+
+    void push_front(Type& value)
+    {
+        insert(begin(), value);
+    }
+
+    void push_back(Type& value)
+    {
+        insert(end(), value);
+    }
+
+    void pop_front()
+    {
+        erase(begin());
+    }
+
+    void pop_back()
+    {
+        erase(iterator(_last_node.prev));
+    }
+
+    iterator insert(iterator position, Type& value)
+    {
+        intrusive_list_node_type* node = &value;
+        intrusive_list_node_type* next = position._node;
+        intrusive_list_node_type* prev = next->prev;
+        node->prev = prev;
+        node->next = next;
+        prev->next = node;
+        next->prev = node;
+        ++_size;
+        return iterator(node);
+    }
+
+    iterator erase(iterator position)
+    {
+        BN_BASIC_ASSERT(!empty(), "List is empty");
+
+        intrusive_list_node_type* node = position._node;
+        intrusive_list_node_type* next = node->next;
+        node->prev->next = next;
+        next->prev = node->prev;
+        node->prev = nullptr;
+        node->next = nullptr;
+        --_size;
+        return iterator(next);
+    }
+
+    iterator erase(Type& value)
+    {
+        return erase(iterator(&value));
+    }
+
+    void clear()
+    {
+        while (!empty())
+            pop_front();
+    }
+
+private:
+    intrusive_list_node_type _first_node;
+    intrusive_list_node_type _last_node;
+    int _size = 0;
+};
+
+} // namespace bn
@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_math.h`.
+
+#pragma once
+
+namespace bn
+{
+
+template <typename Type>
+constexpr Type abs(Type value)
+{
+    return value >= 0 ? value : -value;
+}
+
+} // namespace bn
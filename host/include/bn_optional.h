@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_optional.h`.
+
+#pragma once
+
+#include <optional>
+
+namespace bn
+{
+
+using nullopt_t = std::nullopt_t;
+
+inline constexpr nullopt_t nullopt = std::nullopt;
+
+template <typename Type>
+class optional : public std::optional<Type>
+{
+public:
+    using std::optional<Type>::optional;
+    using std::optional<Type>::operator=;
+};
+
+} // namespace bn
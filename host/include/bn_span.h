@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_span.h`.
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+namespace bn
+{
+
+template <typename Type>
+class span
+{
+public:
+    using element_type = Type;
+    using value_type = std::remove_cv_t<Type>;
+    using size_type = int;
+    using pointer = Type*;
+    using reference = Type&;
+    using iterator = Type*;
+
+    constexpr span() = default;
+
+    constexpr span(pointer ptr, size_type size) : _data(ptr), _size(size)
+    {
+    }
+
+    constexpr span(pointer first, pointer last) : _data(first), _size(static_cast<size_type>(last - first))
+    {
+    }
+
+    template <std::size_t ArraySize>
+    constexpr span(element_type (&array)[ArraySize]) : _data(array), _size(static_cast<size_type>(ArraySize))
+    {
+    }
+
+    template <typename OtherType>
+        requires std::is_convertible_v<OtherType (*)[], Type (*)[]>
+    constexpr span(const span<OtherType>& other) : _data(other.data()), _size(other.size())
+    {
+    }
+
+    template <typename Container>
+        requires requires(Container& container) {
+            { container.data() } -> std::convertible_to<pointer>;
+            container.size();
+        } && (!std::is_same_v<std::remove_cvref_t<Container>, span>)
+    constexpr span(Container& container) : _data(container.data()), _size(static_cast<size_type>(container.size()))
+    {
+    }
+
+    [[nodiscard]] constexpr pointer data() const
+    {
+        return _data;
+    }
+
+    [[nodiscard]] constexpr size_type size() const
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr size_type size_bytes() const
+    {
+        return _size * static_cast<size_type>(sizeof(element_type));
+    }
+
+    [[nodiscard]] constexpr bool empty() const
+    {
+        return _size == 0;
+    }
+
+    [[nodiscard]] constexpr reference operator[](size_type index) const
+    {
+        return _data[index];
+    }
+
+    [[nodiscard]] constexpr span first(size_type count) const
+    {
+        return span(_data, count);
+    }
+
+    [[nodiscard]] constexpr span last(size_type count) const
+    {
+        return span(_data + (_size - count), count);
+    }
+
+    [[nodiscard]] constexpr span subspan(size_type offset) const
+    {
+        return span(_data + offset, _size - offset);
+    }
+
+    [[nodiscard]] constexpr span subspan(size_type offset, size_type count) const
+    {
+        return span(_data + offset, count);
+    }
+
+    [[nodiscard]] constexpr iterator begin() const
+    {
+        return _data;
+    }
+
+    [[nodiscard]] constexpr iterator end() const
+    {
+        return _data + _size;
+    }
+
+private:
+    pointer _data = nullptr;
+    size_type _size = 0;
+};
+
+template <typename Type, std::size_t ArraySize>
+span(Type (&)[ArraySize]) -> span<Type>;
+
+template <typename Container>
+span(Container&) -> span<std::remove_pointer_t<decltype(std::declval<Container&>().data())>>;
+
+} // namespace bn
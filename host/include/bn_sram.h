@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_sram.h`, backed by a static 32 KiB buffer.
+
+#pragma once
+
+#include "bn_assert.h"
+#include "bn_span.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace bn::sram
+{
+
+namespace host
+{
+
+inline std::uint8_t memory[32 * 1024];
+
+} // namespace host
+
+[[nodiscard]] constexpr int size()
+{
+    return int(sizeof(host::memory));
+}
+
+template <typename Type>
+void read_span_offset(const span<Type>& destination, int offset)
+{
+    BN_ASSERT(offset >= 0 && offset + destination.size_bytes() <= size(), "Invalid read: ", offset);
+
+    std::memcpy(destination.data(), host::memory + offset, std::size_t(destination.size_bytes()));
+}
+
+template <typename Type>
+void write_span_offset(const span<const Type>& source, int offset)
+{
+    BN_ASSERT(offset >= 0 && offset + source.size_bytes() <= size(), "Invalid write: ", offset);
+
+    std::memcpy(host::memory + offset, source.data(), std::size_t(source.size_bytes()));
+}
+
+template <typename Type>
+void read_offset(Type& destination, int offset)
+{
+    read_span_offset(span<Type>(&destination, 1), offset);
+}
+
+template <typename Type>
+void write_offset(const Type& source, int offset)
+{
+    write_span_offset(span<const Type>(&source, 1), offset);
+}
+
+} // namespace bn::sram
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_string.h`.
+
+#pragma once
+
+#include "bn_assert.h"
+#include "bn_string_view.h"
+
+namespace bn
+{
+
+template <int MaxSize>
+class string
+{
+public:
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    constexpr string() = default;
+
+    constexpr string(string_view view)
+    {
+        BN_ASSERT(view.size() <= MaxSize, "Not enough space: ", view.size());
+        for (char ch : view)
+            _chars[_size++] = ch;
+    }
+
+    [[nodiscard]] constexpr int size() const
+    {
+        return _size;
+    }
+
+    [[nodiscard]] constexpr int length() const
+    {
+        return _size;
+    }
+
+    [[nodiscard]] static constexpr int max_size()
+    {
+        return MaxSize;
+    }
+
+    [[nodiscard]] constexpr const char* data() const
+    {
+        return _chars;
+    }
+
+    constexpr void resize(int size)
+    {
+        BN_ASSERT(size >= 0 && size <= MaxSize, "Invalid size: ", size);
+        _size = size;
+    }
+
+    constexpr void clear()
+    {
+        _size = 0;
+    }
+
+    [[nodiscard]] constexpr iterator begin()
+    {
+        return _chars;
+    }
+
+    [[nodiscard]] constexpr iterator end()
+    {
+        return _chars + _size;
+    }
+
+    [[nodiscard]] constexpr const_iterator begin() const
+    {
+        return _chars;
+    }
+
+    [[nodiscard]] constexpr const_iterator end() const
+    {
+        return _chars + _size;
+    }
+
+    [[nodiscard]] constexpr operator string_view() const
+    {
+        return string_view(_chars, static_cast<std::size_t>(_size));
+    }
+
+private:
+    char _chars[MaxSize + 1] = {};
+    int _size = 0;
+};
+
+} // namespace bn
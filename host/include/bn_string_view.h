@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_string_view.h`.
+
+#pragma once
+
+#include <string_view>
+
+namespace bn
+{
+
+class string_view : public std::string_view
+{
+public:
+    using std::string_view::string_view;
+
+    constexpr string_view(std::string_view other) : std::string_view(other)
+    {
+    }
+
+    [[nodiscard]] constexpr int size() const
+    {
+        return static_cast<int>(std::string_view::size());
+    }
+
+    [[nodiscard]] constexpr int length() const
+    {
+        return size();
+    }
+};
+
+} // namespace bn
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_timer.h`, backed by `std::chrono::steady_clock`.
+
+#pragma once
+
+#include "bn_timers.h"
+
+#include <chrono>
+
+namespace bn
+{
+
+class timer
+{
+public:
+    timer() : _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    [[nodiscard]] int elapsed_ticks() const
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - _start;
+        return int(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * timers::ticks_per_second() /
+                   1'000'000'000);
+    }
+
+    int elapsed_ticks_with_restart()
+    {
+        const int result = elapsed_ticks();
+        restart();
+        return result;
+    }
+
+    void restart()
+    {
+        _start = std::chrono::steady_clock::now();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace bn
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Host stand-in for Butano's `bn_timers.h`, with the same tick rate as the GBA (CPU clock / 64).
+
+#pragma once
+
+namespace bn::timers
+{
+
+[[nodiscard]] constexpr int ticks_per_second()
+{
+    return 16777216 / 64;
+}
+
+[[nodiscard]] constexpr int ticks_per_frame()
+{
+    return 280896 / 64;
+}
+
+} // namespace bn::timers
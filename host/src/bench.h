@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+namespace bench
+{
+
+/// @brief Prevents the compiler from optimizing away @p value.
+template <typename T>
+inline void do_not_optimize(T& value)
+{
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+/// @brief Checks if the benchmark @p name is selected by the command line filter.
+bool selected(std::string_view name);
+
+/// @brief Runs @p fn repeatedly for a while, and prints the time per call (and throughput).
+/// @param name Name of the benchmark.
+/// @param bytes_per_call Number of bytes processed per call. `0` to not print the throughput.
+/// @param fn Callable to benchmark.
+template <typename Fn>
+void run(std::string_view name, std::size_t bytes_per_call, Fn&& fn)
+{
+    using clock = std::chrono::steady_clock;
+
+    if (!selected(name))
+        return;
+
+    // Warm up, and find the number of calls that takes long enough to measure.
+    std::uint64_t calls = 1;
+    double elapsed_ns = 0;
+    while (true)
+    {
+        const auto begin = clock::now();
+        for (std::uint64_t i = 0; i < calls; ++i)
+            fn();
+        elapsed_ns = std::chrono::duration<double, std::nano>(clock::now() - begin).count();
+
+        if (elapsed_ns >= 100'000'000.0 || calls >= (std::uint64_t(1) << 40))
+            break;
+
+        calls *= 2;
+    }
+
+    const double ns_per_call = elapsed_ns / static_cast<double>(calls);
+    if (bytes_per_call == 0)
+    {
+        std::printf("%-40.*s %12.2f ns/call\n", static_cast<int>(name.size()), name.data(), ns_per_call);
+    }
+    else
+    {
+        const double mib_per_sec = (static_cast<double>(bytes_per_call) / (1024.0 * 1024.0)) / (ns_per_call * 1e-9);
+        std::printf("%-40.*s %12.2f ns/call %10.1f MiB/s\n", static_cast<int>(name.size()), name.data(), ns_per_call,
+                    mib_per_sec);
+    }
+}
+
+void run_bit_stream_benchmarks();
+void run_crc32_benchmarks();
+void run_checksum_benchmarks();
+void run_task_benchmarks();
+void run_timer_wheel_benchmarks();
+void run_observer_benchmarks();
+void run_sram_rw_benchmarks();
+void run_sram_journal_benchmarks();
+void run_sram_kv_store_benchmarks();
+void run_sram_save_slots_benchmarks();
+
+} // namespace bench
@@ -0,0 +1,328 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_bit_stream.h"
+#include "ibn_bit_stream_section.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int BUFFER_WORDS = 16 * 1024 / sizeof(ibn::bit_stream_writer::word_type);
+constexpr int RECORDS = 1024;
+
+// Mixes full words, some ranged integers and a flag, like a typical save record.
+struct record
+{
+    std::int32_t score;
+    std::uint8_t level;
+    std::uint16_t item;
+    bool flag;
+    std::uint64_t play_time;
+};
+
+auto make_records() -> std::array<record, RECORDS>
+{
+    std::array<record, RECORDS> records;
+    for (int i = 0; i < RECORDS; ++i)
+        records[i] = {i * 7919 - 100000, static_cast<std::uint8_t>(i % 100), static_cast<std::uint16_t>(i * 31 % 1000),
+                      i % 3 == 0, static_cast<std::uint64_t>(i) * 0x1'0000'0001};
+    return records;
+}
+
+// Copies the drained chunks to a contiguous buffer, like `ibn::sram_rw::write_streamed()` does to the SRAM.
+class copy_sink final : public ibn::bit_stream_sink
+{
+public:
+    explicit copy_sink(ibn::bit_stream_writer::word_type* destination) : _destination(destination)
+    {
+    }
+
+    void consume(bn::span<const ibn::bit_stream_writer::word_type> words) override
+    {
+        std::memcpy(_destination, words.data(), words.size_bytes());
+        _destination += words.size();
+    }
+
+private:
+    ibn::bit_stream_writer::word_type* _destination;
+};
+
+// Copies the chunks from a contiguous buffer, like `ibn::sram_rw::read_streamed()` does from the SRAM.
+class copy_source final : public ibn::bit_stream_source
+{
+public:
+    copy_source(const ibn::bit_stream_reader::word_type* source, int words_count)
+        : _source(source), _words_count(words_count)
+    {
+    }
+
+    void fetch(ibn::bit_stream_reader::size_type first_word_index,
+               bn::span<ibn::bit_stream_reader::word_type> words) override
+    {
+        const int count = std::max(0, std::min(words.size(), _words_count - int(first_word_index)));
+        std::memcpy(words.data(), _source + first_word_index, count * sizeof(ibn::bit_stream_reader::word_type));
+    }
+
+private:
+    const ibn::bit_stream_reader::word_type* _source;
+    int _words_count;
+};
+
+template <typename Stream>
+void write_records(Stream& writer, const std::array<record, RECORDS>& records)
+{
+    for (const record& rec : records)
+    {
+        writer.write(rec.score);
+        writer.write(rec.level, std::uint8_t(0), std::uint8_t(99));
+        writer.write(rec.item, std::uint16_t(0), std::uint16_t(999));
+        writer.write(rec.flag);
+        writer.write(rec.play_time, std::uint64_t(0), std::uint64_t(1) << 45);
+    }
+}
+
+// Section payload, whose newer version appends a field
+struct player_section
+{
+    std::int32_t score;
+    std::uint16_t item;
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        measurer.write(score).write(item);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        writer.write(score).write(item);
+    }
+};
+
+constexpr std::uint16_t PLAYER_SECTION_ID = 1;
+constexpr std::uint16_t UNKNOWN_SECTION_ID = 7;
+
+void check_bit_stream_sections()
+{
+    if (!selected("bit_stream/check/sections"))
+        return;
+
+    std::array<ibn::bit_stream_writer::word_type, 64> buffer{};
+    constexpr auto BUFFER_BYTES = ibn::bit_stream_writer::size_type(sizeof(buffer));
+
+    // Round trip, where the reader knows only the first field of the player, and not the unknown section
+    {
+        const player_section players[] = {{-12345, 678}, {42, 999}};
+        ibn::bit_stream_writer writer(buffer, BUFFER_BYTES);
+        ibn::write_section(writer, PLAYER_SECTION_ID, 2, players[0]);
+        ibn::write_section(writer, UNKNOWN_SECTION_ID, 0, player_section{7, 7});
+        ibn::write_section(writer, PLAYER_SECTION_ID, 2, players[1]);
+        const auto used_bytes = writer.used_bytes();
+        writer.flush_final();
+
+        ibn::bit_stream_reader reader(buffer, used_bytes);
+        ibn::bit_stream_section_header header;
+        std::int32_t scores[2] = {};
+        int players_read = 0, skipped = 0;
+        while (reader.unused_bits() >= header.BITS && ibn::read_section_header(reader, header))
+        {
+            if (header.id == PLAYER_SECTION_ID && players_read < 2)
+                ibn::read_section(reader, header, [&](ibn::bit_stream_reader& r) { r.read(scores[players_read++]); });
+            else if (ibn::skip_section(reader, header))
+                ++skipped;
+        }
+
+        if (!writer || !reader || players_read != 2 || skipped != 1 || scores[0] != players[0].score ||
+            scores[1] != players[1].score || reader.unused_bits() != 0)
+            std::printf("bit_stream/check/sections/round_trip: MISMATCH\n");
+    }
+
+    // Payload that writes more than it measured
+    {
+        struct lying_section
+        {
+            void measure(ibn::bit_stream_measurer& measurer) const
+            {
+                measurer.write(std::uint8_t(0));
+            }
+
+            void write(ibn::bit_stream_writer& writer) const
+            {
+                writer.write(std::uint16_t(0));
+            }
+        };
+
+        ibn::bit_stream_writer writer(buffer, BUFFER_BYTES);
+        ibn::write_section(writer, PLAYER_SECTION_ID, 0, lying_section{});
+        if (writer)
+            std::printf("bit_stream/check/sections/lying_payload: MISMATCH\n");
+    }
+
+    // Corrupt lengths fail without moving the reader
+    for (const ibn::bit_stream_section_header::size_type bits :
+         {ibn::bit_stream_section_header::size_type(0xFFFF'FFF8), ibn::bit_stream_section_header::size_type(0x7FFF'FFFF),
+          ibn::bit_stream_section_header::size_type(8 * BUFFER_BYTES)})
+    {
+        ibn::bit_stream_writer writer(buffer, BUFFER_BYTES);
+        writer.write(PLAYER_SECTION_ID).write(std::uint8_t(0)).write(bits);
+        player_section{1, 2}.write(writer);
+        const auto used_bytes = writer.used_bytes();
+        writer.flush_final();
+
+        ibn::bit_stream_reader skip_reader(buffer, used_bytes);
+        ibn::bit_stream_section_header header;
+        const bool header_read = ibn::read_section_header(skip_reader, header);
+        const auto header_end = skip_reader.used_bits();
+        const bool skipped = ibn::skip_section(skip_reader, header);
+
+        ibn::bit_stream_reader read_reader(buffer, used_bytes);
+        ibn::read_section_header(read_reader, header);
+        std::int32_t score = 0;
+        const bool read = ibn::read_section(read_reader, header, [&](ibn::bit_stream_reader& r) { r.read(score); });
+
+        if (!header_read || header.bits != bits || skipped || skip_reader || skip_reader.used_bits() != header_end ||
+            read || read_reader || score != 1)
+            std::printf("bit_stream/check/sections/corrupt_length/%u: MISMATCH\n", unsigned(bits));
+    }
+
+    // Payload that reads past its length
+    {
+        ibn::bit_stream_writer writer(buffer, BUFFER_BYTES);
+        writer.write(PLAYER_SECTION_ID).write(std::uint8_t(0)).write(ibn::bit_stream_section_header::size_type(8));
+        player_section{1, 2}.write(writer);
+        const auto used_bytes = writer.used_bytes();
+        writer.flush_final();
+
+        ibn::bit_stream_reader reader(buffer, used_bytes);
+        ibn::bit_stream_section_header header;
+        ibn::read_section_header(reader, header);
+        std::int32_t score = 0;
+        if (ibn::read_section(reader, header, [&](ibn::bit_stream_reader& r) { r.read(score); }) || reader)
+            std::printf("bit_stream/check/sections/overread: MISMATCH\n");
+    }
+}
+
+} // namespace
+
+void run_bit_stream_benchmarks()
+{
+    check_bit_stream_sections();
+
+    static std::array<ibn::bit_stream_writer::word_type, BUFFER_WORDS> buffer;
+    const auto records = make_records();
+
+    ibn::bit_stream_measurer measurer;
+    write_records(measurer, records);
+    const auto used_bytes = measurer.used_bytes();
+
+    run("bit_stream/write_records", used_bytes, [&] {
+        ibn::bit_stream_writer writer(buffer, used_bytes);
+        write_records(writer, records);
+        writer.flush_final();
+        do_not_optimize(buffer);
+    });
+
+    if (selected("bit_stream/write_records_chunked"))
+    {
+        // Chunked output must be the same as the contiguous one
+        ibn::bit_stream_writer writer(buffer, used_bytes);
+        write_records(writer, records);
+        writer.flush_final();
+
+        static std::array<ibn::bit_stream_writer::word_type, BUFFER_WORDS> chunked_buffer;
+        std::array<ibn::bit_stream_writer::word_type, 64> chunk;
+        copy_sink sink(chunked_buffer.data());
+        ibn::bit_stream_writer chunked_writer(chunk, used_bytes, sink);
+        write_records(chunked_writer, records);
+        chunked_writer.flush_final();
+
+        if (!chunked_writer || std::memcmp(chunked_buffer.data(), buffer.data(), used_bytes) != 0)
+            std::printf("bit_stream/write_records_chunked: MISMATCH\n");
+    }
+
+    run("bit_stream/write_records_chunked", used_bytes, [&] {
+        static std::array<ibn::bit_stream_writer::word_type, BUFFER_WORDS> chunked_buffer;
+        std::array<ibn::bit_stream_writer::word_type, 64> chunk;
+        copy_sink sink(chunked_buffer.data());
+        ibn::bit_stream_writer writer(chunk, used_bytes, sink);
+        write_records(writer, records);
+        writer.flush_final();
+        do_not_optimize(chunked_buffer);
+    });
+
+    run("bit_stream/read_records", used_bytes, [&] {
+        ibn::bit_stream_reader reader(buffer, used_bytes);
+        record rec;
+        for (int i = 0; i < RECORDS; ++i)
+        {
+            reader.read(rec.score);
+            reader.read(rec.level, std::uint8_t(0), std::uint8_t(99));
+            reader.read(rec.item, std::uint16_t(0), std::uint16_t(999));
+            reader.read(rec.flag);
+            reader.read(rec.play_time, std::uint64_t(0), std::uint64_t(1) << 45);
+            do_not_optimize(rec);
+        }
+    });
+
+    if (selected("bit_stream/read_records_chunked"))
+    {
+        // Chunked input must be read the same as the contiguous one
+        ibn::bit_stream_writer writer(buffer, used_bytes);
+        write_records(writer, records);
+        writer.flush_final();
+
+        std::array<ibn::bit_stream_reader::word_type, 64> chunk;
+        copy_source source(buffer.data(), buffer.size());
+        ibn::bit_stream_reader reader(chunk, used_bytes, source);
+        bool same = true;
+        for (const record& expected : records)
+        {
+            record rec = {};
+            reader.read(rec.score);
+            reader.read(rec.level, std::uint8_t(0), std::uint8_t(99));
+            reader.read(rec.item, std::uint16_t(0), std::uint16_t(999));
+            reader.read(rec.flag);
+            reader.read(rec.play_time, std::uint64_t(0), std::uint64_t(1) << 45);
+            same = same && rec.score == expected.score && rec.level == expected.level && rec.item == expected.item &&
+                   rec.flag == expected.flag && rec.play_time == expected.play_time;
+        }
+
+        if (!reader || !same)
+            std::printf("bit_stream/read_records_chunked: MISMATCH\n");
+    }
+
+    run("bit_stream/read_records_chunked", used_bytes, [&] {
+        std::array<ibn::bit_stream_reader::word_type, 64> chunk;
+        copy_source source(buffer.data(), buffer.size());
+        ibn::bit_stream_reader reader(chunk, used_bytes, source);
+        record rec;
+        for (int i = 0; i < RECORDS; ++i)
+        {
+            reader.read(rec.score);
+            reader.read(rec.level, std::uint8_t(0), std::uint8_t(99));
+            reader.read(rec.item, std::uint16_t(0), std::uint16_t(999));
+            reader.read(rec.flag);
+            reader.read(rec.play_time, std::uint64_t(0), std::uint64_t(1) << 45);
+            do_not_optimize(rec);
+        }
+    });
+
+    run("bit_stream/write_bytes", sizeof(buffer), [&] {
+        static std::array<std::uint8_t, sizeof(buffer)> bytes;
+        ibn::bit_stream_writer writer(buffer, sizeof(buffer));
+        writer.write(bytes.data(), bytes.size());
+        writer.flush_final();
+        do_not_optimize(buffer);
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_checksum.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+
+namespace bench
+{
+
+namespace
+{
+
+struct checksum_algorithm
+{
+    const char* name;
+    ibn::checksum_kind kind;
+};
+
+constexpr checksum_algorithm ALGORITHMS[] = {
+    {"crc32", ibn::checksum_kind::CRC32},
+    {"fletcher32", ibn::checksum_kind::FLETCHER32},
+    {"adler32", ibn::checksum_kind::ADLER32},
+    {"xxhash32", ibn::checksum_kind::XXHASH32},
+};
+
+struct known_answer
+{
+    ibn::checksum_kind kind;
+    const char* text;
+    std::uint32_t checksum;
+};
+
+constexpr known_answer KNOWN_ANSWERS[] = {
+    {ibn::checksum_kind::CRC32, "123456789", 0xCBF43926},
+    {ibn::checksum_kind::FLETCHER32, "abcde", 0xF04FC729},
+    {ibn::checksum_kind::FLETCHER32, "abcdef", 0x56502D2A},
+    {ibn::checksum_kind::FLETCHER32, "abcdefgh", 0xEBE19591},
+    {ibn::checksum_kind::ADLER32, "Wikipedia", 0x11E60398},
+    {ibn::checksum_kind::ADLER32, "", 0x00000001},
+    {ibn::checksum_kind::XXHASH32, "", 0x02CC5D05},
+    {ibn::checksum_kind::XXHASH32, "abc", 0x32D153FF},
+};
+
+constexpr std::size_t SIZES[] = {16, 256, 4 * 1024};
+
+// Corruptions that a save data would likely suffer
+enum class corruption
+{
+    BIT_FLIP,
+    TWO_BIT_FLIPS,
+    BURST_32,
+    BURST_64,
+    WORD_SWAP,
+    ERASED_RUN,
+
+    COUNT
+};
+
+constexpr const char* CORRUPTION_NAMES[] = {"1bit", "2bits", "burst32", "burst64", "swap", "erased"};
+
+constexpr std::size_t DETECTION_BYTES = 256;
+constexpr int DETECTION_TRIALS = 20000;
+
+// Corrupts `data` in place, which is guaranteed to differ from the original afterwards.
+void corrupt(std::array<std::uint8_t, DETECTION_BYTES>& data, corruption type, std::mt19937& random)
+{
+    const auto flip_bit = [&](unsigned bit) { data[bit / 8] ^= std::uint8_t(1 << (bit % 8)); };
+    constexpr unsigned BITS = DETECTION_BYTES * 8;
+
+    switch (type)
+    {
+    case corruption::BIT_FLIP:
+        flip_bit(random() % BITS);
+        break;
+
+    case corruption::TWO_BIT_FLIPS: {
+        const unsigned first = random() % BITS;
+        const unsigned second = (first + 1 + random() % (BITS - 1)) % BITS;
+        flip_bit(first);
+        flip_bit(second);
+        break;
+    }
+
+    case corruption::BURST_32:
+    case corruption::BURST_64: {
+        // Both ends of the burst are flipped, and the bits between are random
+        const unsigned max_length = (type == corruption::BURST_32) ? 32 : 64;
+        const unsigned length = 2 + random() % (max_length - 1);
+        const unsigned first = random() % (BITS - length + 1);
+        flip_bit(first);
+        flip_bit(first + length - 1);
+        for (unsigned bit = first + 1; bit < first + length - 1; ++bit)
+            if (random() % 2)
+                flip_bit(bit);
+        break;
+    }
+
+    case corruption::WORD_SWAP: {
+        // Two different 16-bit words are swapped, like a misordered write
+        constexpr unsigned WORDS = DETECTION_BYTES / 2;
+        unsigned first, second;
+        do
+        {
+            first = random() % WORDS;
+            second = random() % WORDS;
+        } while (std::memcmp(&data[first * 2], &data[second * 2], 2) == 0);
+        for (int byte = 0; byte < 2; ++byte)
+            std::swap(data[first * 2 + byte], data[second * 2 + byte]);
+        break;
+    }
+
+    case corruption::ERASED_RUN: {
+        // A run of bytes reads back as erased (`0xFF`) or cleared (`0x00`), like an interrupted write
+        const std::array<std::uint8_t, DETECTION_BYTES> original = data;
+        do
+        {
+            data = original;
+            const unsigned length = 4 + random() % 29;
+            const unsigned first = random() % (DETECTION_BYTES - length + 1);
+            std::fill_n(data.begin() + first, length, (random() % 2) ? 0xFF : 0x00);
+        } while (data == original);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+auto checksum_of(ibn::checksum_kind kind, const void* data, std::size_t length) -> std::uint32_t
+{
+    return ibn::checksum_stream(kind).update(data, length).value();
+}
+
+} // namespace
+
+void run_checksum_benchmarks()
+{
+    for (const known_answer& answer : KNOWN_ANSWERS)
+        if (checksum_of(answer.kind, answer.text, std::strlen(answer.text)) != answer.checksum)
+            std::printf("checksum/known_answer/%d/\"%s\": MISMATCH\n", int(answer.kind), answer.text);
+
+    static std::array<std::uint8_t, 4 * 1024 + 3> data;
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<std::uint8_t>(i * 2654435761u >> 24);
+
+    char name[64];
+    for (const checksum_algorithm& algorithm : ALGORITHMS)
+    {
+        // Feeding chunk by chunk (of odd sizes) must be the same as all at once
+        const std::uint32_t expected = checksum_of(algorithm.kind, data.data(), data.size());
+        for (std::size_t chunk_size : {1, 3, 7, 16, 17, 1000})
+        {
+            ibn::checksum_stream stream(algorithm.kind);
+            for (std::size_t offset = 0; offset < data.size(); offset += chunk_size)
+                stream.update(data.data() + offset, std::min(chunk_size, data.size() - offset));
+            if (stream.value() != expected)
+                std::printf("checksum/%s/chunked/%zu: MISMATCH\n", algorithm.name, chunk_size);
+        }
+
+        for (std::size_t size : SIZES)
+        {
+            std::snprintf(name, sizeof(name), "checksum/%s/%zu", algorithm.name, size);
+            run(name, size, [&] {
+                std::uint32_t checksum = checksum_of(algorithm.kind, data.data(), size);
+                do_not_optimize(checksum);
+            });
+        }
+    }
+
+    // Error detection strength, as the number of corruptions undetected
+    for (const checksum_algorithm& algorithm : ALGORITHMS)
+    {
+        std::snprintf(name, sizeof(name), "checksum/%s/detection", algorithm.name);
+        if (!selected(name))
+            continue;
+
+        std::mt19937 random(20250101);
+        std::printf("%-40s", name);
+
+        for (int type = 0; type < int(corruption::COUNT); ++type)
+        {
+            int undetected = 0;
+            for (int trial = 0; trial < DETECTION_TRIALS; ++trial)
+            {
+                // Save data is mostly zeros, with a few fields set
+                std::array<std::uint8_t, DETECTION_BYTES> corrupted;
+                for (std::uint8_t& byte : corrupted)
+                    byte = (random() % 4 == 0) ? std::uint8_t(random()) : 0;
+
+                const std::uint32_t original = checksum_of(algorithm.kind, corrupted.data(), corrupted.size());
+                corrupt(corrupted, corruption(type), random);
+                if (checksum_of(algorithm.kind, corrupted.data(), corrupted.size()) == original)
+                    ++undetected;
+            }
+
+            std::printf(" %s %d", CORRUPTION_NAMES[type], undetected);
+        }
+
+        std::printf(" (undetected of %d each)\n", DETECTION_TRIALS);
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_checksum.h"
+#include "ibn_crc32.h"
+#include "ibn_crc32_block_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace bench
+{
+
+namespace
+{
+
+using crc32_fn = std::uint32_t (*)(const void*, std::size_t, std::uint32_t);
+
+struct crc32_kernel
+{
+    const char* name;
+    crc32_fn fn;
+};
+
+constexpr crc32_kernel KERNELS[] = {
+    {"fast", ibn::crc32_fast},
+    {"bitwise", ibn::crc32_bitwise},
+    {"halfbyte", ibn::crc32_halfbyte},
+#ifdef CRC32_USE_LOOKUP_TABLE_BYTE
+    {"1byte", ibn::crc32_1byte},
+#endif
+    {"1byte_tableless", ibn::crc32_1byte_tableless},
+    {"1byte_tableless2", ibn::crc32_1byte_tableless2},
+#ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_4
+    {"4bytes", ibn::crc32_4bytes},
+    {"4x4bytes_arm", ibn::crc32_4x4bytes_arm},
+#endif
+#ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_8
+    {"8bytes", ibn::crc32_8bytes},
+    {"4x8bytes", ibn::crc32_4x8bytes},
+#endif
+#ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_16
+    {"16bytes", ibn::crc32_16bytes},
+#endif
+#ifdef IBN_CRC32_HARDWARE
+    {"hardware", ibn::crc32_hardware},
+#endif
+};
+
+constexpr std::size_t SIZES[] = {16, 256, 4 * 1024, 32 * 1024};
+
+} // namespace
+
+void run_crc32_benchmarks()
+{
+    static std::array<std::uint8_t, 32 * 1024> data;
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<std::uint8_t>(i * 2654435761u >> 24);
+
+    char name[64];
+    for (const crc32_kernel& kernel : KERNELS)
+    {
+        // Every kernel must agree with each other
+        if (kernel.fn(data.data(), data.size(), 0) != ibn::crc32_bitwise(data.data(), data.size(), 0))
+            std::printf("crc32/%s: MISMATCH\n", kernel.name);
+
+        // Including the unaligned head & the leftover tail
+        for (std::size_t offset = 1; offset < 4; ++offset)
+            if (kernel.fn(data.data() + offset, 37, 0x1234) != ibn::crc32_bitwise(data.data() + offset, 37, 0x1234))
+                std::printf("crc32/%s/unaligned: MISMATCH\n", kernel.name);
+
+        // Every length around the folding & the unrolling boundaries
+        for (std::size_t length = 0; length <= 300; ++length)
+            if (kernel.fn(data.data() + 5, length, 0x1234) != ibn::crc32_bitwise(data.data() + 5, length, 0x1234))
+            {
+                std::printf("crc32/%s/length/%zu: MISMATCH\n", kernel.name, length);
+                break;
+            }
+
+        for (std::size_t size : SIZES)
+        {
+            std::snprintf(name, sizeof(name), "crc32/%s/%zu", kernel.name, size);
+            run(name, size, [&] {
+                std::uint32_t crc = kernel.fn(data.data(), size, 0);
+                do_not_optimize(crc);
+            });
+        }
+    }
+
+    // Feeding chunk by chunk must be the same as all at once
+    ibn::checksum_stream stream = ibn::checksum_stream::crc32(0);
+    for (std::size_t offset = 0; offset < data.size(); offset += 1000)
+        stream.update(bn::span(data).subspan(offset, std::min(std::size_t(1000), data.size() - offset)));
+    if (stream.value() != ibn::crc32_fast(data.data(), data.size()))
+        std::printf("crc32/stream: MISMATCH\n");
+
+    // Block tree must be the same as the crc32 of the whole data, after changing blocks (with a partial last block)
+    constexpr unsigned TREE_BLOCK_SIZE = 256;
+    static ibn::crc32_block_tree<int(32 * 1024 / TREE_BLOCK_SIZE)> tree(TREE_BLOCK_SIZE);
+    bn::span<std::uint8_t> tree_data(data.data(), data.size() - 100);
+    tree.reset(tree_data);
+
+    for (int change = 0; change < 64; ++change)
+    {
+        const int index = (change * 37) % tree.blocks_count();
+        const unsigned offset = index * TREE_BLOCK_SIZE;
+        tree_data[offset] ^= std::uint8_t(change + 1);
+        const unsigned size = std::min(TREE_BLOCK_SIZE, unsigned(tree_data.size()) - offset);
+        tree.update_block(index, tree_data.subspan(offset, size));
+    }
+    if (tree.crc32() != ibn::crc32_fast(tree_data.data(), tree_data.size()))
+        std::printf("crc32/block_tree: MISMATCH\n");
+
+    run("crc32/block_tree/update", TREE_BLOCK_SIZE, [&] {
+        ++tree_data[0];
+        tree.update_block(0, tree_data.first(TREE_BLOCK_SIZE));
+        std::uint32_t crc = tree.crc32();
+        do_not_optimize(crc);
+    });
+
+    static constexpr ibn::crc32_combiner combiner(4096);
+    std::uint32_t combined = 0x12345678;
+    run("crc32/combiner/4096", 0, [&] {
+        combined = combiner.combine(combined, 0x9abcdef0);
+        do_not_optimize(combined);
+    });
+
+    run("crc32/combine/4096", 0, [&] {
+        std::uint32_t crc = ibn::crc32_combine(0x12345678, 0x9abcdef0, 4096);
+        do_not_optimize(crc);
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_observer.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace bench
+{
+
+void run_observer_benchmarks()
+{
+    using subject_t = ibn::subject<void(int)>;
+    using observer_t = subject_t::observer_t;
+
+    int sum = 0;
+
+    char name[64];
+    for (int observers_count : {1, 16, 128})
+    {
+        subject_t subject;
+        std::vector<std::unique_ptr<observer_t>> observers;
+        for (int i = 0; i < observers_count; ++i)
+        {
+            observers.push_back(std::make_unique<observer_t>([&sum](int value) { sum += value; }));
+            subject.attach(*observers.back());
+        }
+
+        std::snprintf(name, sizeof(name), "observer/notify/%d", observers_count);
+        run(name, 0, [&] {
+            subject.notify(1);
+            do_not_optimize(sum);
+        });
+    }
+
+    subject_t subject;
+    observer_t observer([&sum](int value) { sum += value; });
+    run("observer/attach_detach", 0, [&] {
+        subject.attach(observer);
+        observer.unsubscribe();
+    });
+}
+
+} // namespace bench
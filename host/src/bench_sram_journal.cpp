@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+#include "bench_storage.h"
+
+#include "ibn_sram_journal.h"
+#include "ibn_storage.h"
+
+#include <array>
+#include <cstdio>
+#include <random>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int STORAGE_SIZE = 32 * 1024;
+constexpr int FLASH_ERASE_BLOCK_SIZE = 4 * 1024;
+constexpr unsigned SNAPSHOT_LOCATION_0 = 0;
+constexpr unsigned SNAPSHOT_LOCATION_1 = 4 * 1024;
+constexpr unsigned JOURNAL_LOCATION = 8 * 1024;
+constexpr unsigned JOURNAL_SIZE = 4 * 1024;
+constexpr int COUNTERS = 16;
+
+struct counters
+{
+    std::array<std::uint16_t, COUNTERS> values = {};
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        for (const std::uint16_t value : values)
+            measurer.write(value);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        for (const std::uint16_t value : values)
+            writer.write(value);
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        for (std::uint16_t& value : values)
+            reader.read(value);
+    }
+
+    void apply(ibn::bit_stream_reader& reader)
+    {
+        std::uint8_t index = 0;
+        std::uint16_t value = 0;
+        reader.read(index, std::uint8_t(0), std::uint8_t(COUNTERS - 1)).read(value);
+        if (reader)
+            values[index] = value;
+    }
+
+    bool operator==(const counters&) const = default;
+};
+
+// Same layout as `counters`, but declares another schema
+struct counters_v2 : counters
+{
+    static constexpr std::uint32_t SCHEMA_HASH = ibn::sram_schema_hash("u16 values[16] v2");
+};
+
+struct counter_record
+{
+    std::uint8_t index;
+    std::uint16_t value;
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        measurer.write(index, std::uint8_t(0), std::uint8_t(COUNTERS - 1)).write(value);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        writer.write(index, std::uint8_t(0), std::uint8_t(COUNTERS - 1)).write(value);
+    }
+};
+
+// Passes its checksum, but `counters::apply()` can't read it
+struct malformed_record
+{
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        measurer.write(std::uint8_t(0));
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        writer.write(std::uint8_t(0));
+    }
+};
+
+auto make_journal(ibn::storage& storage) -> ibn::sram_journal
+{
+    return ibn::sram_journal("IBNJR", SNAPSHOT_LOCATION_0, SNAPSHOT_LOCATION_1, JOURNAL_LOCATION, JOURNAL_SIZE,
+                             storage);
+}
+
+// Appends a random record to the journal, and applies it to `expected` too.
+bool append_randomly(ibn::sram_journal& journal, counters& expected, std::mt19937& random)
+{
+    const counter_record record{std::uint8_t(random() % COUNTERS), std::uint16_t(random())};
+    if (!journal.append(record))
+        return false;
+
+    expected.values[record.index] = record.value;
+    return true;
+}
+
+void check_sram_journal(const char* kind, int erase_block_size)
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "sram_journal/check/%s", kind);
+    if (!selected(name))
+        return;
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    memory.fill(0xFF);
+    ibn::memory_storage memory_storage(memory, erase_block_size);
+    power_cut_storage storage(memory_storage);
+    std::mt19937 random(20250101);
+
+    // Nothing to load yet
+    {
+        ibn::sram_journal journal = make_journal(storage);
+        counters loaded;
+        if (journal.load(loaded))
+            std::printf("%s/empty: MISMATCH\n", name);
+    }
+
+    // Round trip
+    counters expected;
+    {
+        ibn::sram_journal journal = make_journal(storage);
+        journal.compact(expected);
+        for (int record = 0; record < 10; ++record)
+            append_randomly(journal, expected, random);
+
+        ibn::sram_journal reloaded = make_journal(storage);
+        counters loaded;
+        if (!reloaded.load(loaded) || loaded != expected ||
+            reloaded.journal_used_bytes() != journal.journal_used_bytes())
+            std::printf("%s/round_trip: MISMATCH\n", name);
+    }
+
+    // Torn records end the journal there, at every byte of the power cut (a record is 12 bytes)
+    for (int budget = 0; budget < 12; ++budget)
+    {
+        counters torn = expected;
+        {
+            ibn::sram_journal journal = make_journal(storage);
+            counters loaded;
+            journal.load(loaded);
+
+            storage.cut_after(budget);
+            append_randomly(journal, torn, random);
+            storage.restore_power();
+        }
+
+        ibn::sram_journal journal = make_journal(storage);
+        counters loaded;
+        if (!journal.load(loaded) || loaded != expected)
+        {
+            std::printf("%s/torn/%d: MISMATCH\n", name, budget);
+            break;
+        }
+
+        // Flash can't write the next record over the torn one, until compacted
+        counters next = loaded;
+        if (!append_randomly(journal, next, random))
+        {
+            journal.compact(loaded);
+            if (!append_randomly(journal, next, random))
+                std::printf("%s/torn/%d/append: MISMATCH\n", name, budget);
+        }
+        expected = next;
+    }
+
+    // Compaction discards the records of the previous generations
+    {
+        ibn::sram_journal journal = make_journal(storage);
+        counters loaded;
+        journal.load(loaded);
+
+        int appended = 0;
+        while (append_randomly(journal, expected, random))
+            ++appended;
+
+        const bool full = journal.journal_used_bytes() + 12 > journal.journal_size();
+        journal.compact(expected);
+        const bool compacted = journal.journal_used_bytes() == 0;
+        for (int record = 0; record < 3; ++record)
+            append_randomly(journal, expected, random);
+
+        ibn::sram_journal reloaded = make_journal(storage);
+        if (!full || !compacted || appended < 100 || !reloaded.load(loaded) || loaded != expected ||
+            reloaded.journal_used_bytes() != 3 * 12)
+            std::printf("%s/compact: MISMATCH\n", name);
+    }
+
+    // Snapshot of another schema is rejected
+    {
+        ibn::sram_journal journal = make_journal(storage);
+        counters_v2 loaded;
+        if (journal.load(loaded))
+            std::printf("%s/schema: MISMATCH\n", name);
+    }
+
+    // Malformed record fails the load, after applying the records before it
+    {
+        ibn::sram_journal journal = make_journal(storage);
+        counters loaded;
+        journal.load(loaded);
+        journal.append(malformed_record{});
+        append_randomly(journal, loaded, random);
+
+        ibn::sram_journal reloaded = make_journal(storage);
+        counters malformed;
+        if (reloaded.load(malformed) || malformed != expected)
+            std::printf("%s/malformed: MISMATCH\n", name);
+    }
+}
+
+} // namespace
+
+void run_sram_journal_benchmarks()
+{
+    check_sram_journal("sram", 1);
+    check_sram_journal("flash", FLASH_ERASE_BLOCK_SIZE);
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    static ibn::memory_storage storage(memory);
+    static ibn::sram_journal journal = make_journal(storage);
+    counters expected;
+    journal.compact(expected);
+    std::mt19937 random(20250101);
+
+    run("sram_journal/append", 12, [&] {
+        if (!append_randomly(journal, expected, random))
+            journal.compact(expected);
+        do_not_optimize(expected);
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+#include "bench_storage.h"
+
+#include "ibn_sram_kv_store.h"
+#include "ibn_storage.h"
+
+#include <array>
+#include <cstdio>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int STORAGE_SIZE = 32 * 1024;
+constexpr unsigned LOCATION = 1024;
+constexpr std::uint16_t MAX_VALUE_SIZES[] = {4, 1, 16, 64};
+
+constexpr ibn::sram_kv_store::key_type VOLUME_KEY = 0;
+constexpr ibn::sram_kv_store::key_type FLAG_KEY = 1;
+constexpr ibn::sram_kv_store::key_type NAME_KEY = 2;
+constexpr ibn::sram_kv_store::key_type UNUSED_KEY = 3;
+
+auto make_store(ibn::storage& storage) -> ibn::sram_kv_store
+{
+    return ibn::sram_kv_store("IBNKV", LOCATION, MAX_VALUE_SIZES, storage);
+}
+
+// Reads the volume from a fresh store, which builds its index again.
+auto reload_volume(ibn::storage& storage) -> int
+{
+    const ibn::sram_kv_store store = make_store(storage);
+    std::uint32_t volume = 0;
+    return store.read_value(VOLUME_KEY, volume) ? int(volume) : -1;
+}
+
+void check_sram_kv_store()
+{
+    if (!selected("sram_kv_store/check"))
+        return;
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    ibn::memory_storage memory_storage(memory);
+    power_cut_storage storage(memory_storage);
+
+    // Put & get, which survive rebuilding the index
+    {
+        ibn::sram_kv_store store = make_store(storage);
+        const bool empty = !store.contains(VOLUME_KEY) && !store.contains(FLAG_KEY) && !store.contains(NAME_KEY);
+
+        store.write_value(VOLUME_KEY, std::uint32_t(70));
+        store.write_value(FLAG_KEY, true);
+
+        const ibn::sram_kv_store reloaded = make_store(storage);
+        std::uint32_t volume = 0;
+        bool flag = false;
+        std::uint8_t name = 0;
+        if (!empty || !reloaded.read_value(VOLUME_KEY, volume) || volume != 70 ||
+            !reloaded.read_value(FLAG_KEY, flag) || !flag || reloaded.read_value(NAME_KEY, name) ||
+            reloaded.contains(UNUSED_KEY))
+            std::printf("sram_kv_store/check/put_get: MISMATCH\n");
+    }
+
+    // Rewrites alternate the two slots of the key, across the sequence wrapping around
+    {
+        ibn::sram_kv_store store = make_store(storage);
+        const unsigned size_bytes = store.size_bytes();
+        for (std::uint32_t volume = 0; volume < 600; ++volume)
+            store.write_value(VOLUME_KEY, volume);
+
+        bool flag = false;
+        if (reload_volume(storage) != 599 || !make_store(storage).read_value(FLAG_KEY, flag) || !flag ||
+            store.size_bytes() != size_bytes)
+            std::printf("sram_kv_store/check/rewrite: MISMATCH\n");
+    }
+
+    // Erase, which can be written again
+    {
+        ibn::sram_kv_store store = make_store(storage);
+        store.erase(VOLUME_KEY);
+        store.erase(UNUSED_KEY);
+        const bool erased =
+            !store.contains(VOLUME_KEY) && !make_store(storage).contains(VOLUME_KEY) && reload_volume(storage) == -1;
+
+        store.write_value(VOLUME_KEY, std::uint32_t(30));
+        if (!erased || reload_volume(storage) != 30 || make_store(storage).contains(UNUSED_KEY))
+            std::printf("sram_kv_store/check/erase: MISMATCH\n");
+    }
+
+    // Torn writes & erases keep the previous value, at every byte of the power cut (a slot is 12 bytes)
+    for (int budget = 0; budget <= 12; ++budget)
+    {
+        const bool complete = (budget == 12);
+
+        storage.cut_after(budget);
+        make_store(storage).write_value(VOLUME_KEY, std::uint32_t(40 + budget));
+        storage.restore_power();
+        const int written = reload_volume(storage);
+        if (written != (complete ? 40 + budget : 30))
+        {
+            std::printf("sram_kv_store/check/torn_write/%d: MISMATCH\n", budget);
+            break;
+        }
+
+        // Tombstone is the header alone
+        storage.cut_after(budget);
+        make_store(storage).erase(VOLUME_KEY);
+        storage.restore_power();
+        if (reload_volume(storage) != ((budget >= 8) ? -1 : written))
+        {
+            std::printf("sram_kv_store/check/torn_erase/%d: MISMATCH\n", budget);
+            break;
+        }
+
+        make_store(storage).write_value(VOLUME_KEY, std::uint32_t(30));
+    }
+}
+
+} // namespace
+
+void run_sram_kv_store_benchmarks()
+{
+    check_sram_kv_store();
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    static ibn::memory_storage storage(memory);
+    static ibn::sram_kv_store store = make_store(storage);
+    std::uint32_t volume = 0;
+
+    run("sram_kv_store/write_value", 4, [&] {
+        store.write_value(VOLUME_KEY, ++volume);
+        do_not_optimize(volume);
+    });
+
+    run("sram_kv_store/read_value", 4, [&] {
+        store.read_value(VOLUME_KEY, volume);
+        do_not_optimize(volume);
+    });
+
+    run("sram_kv_store/build_index", 0, [&] {
+        const ibn::sram_kv_store rebuilt = make_store(storage);
+        bool contains = rebuilt.contains(VOLUME_KEY);
+        do_not_optimize(contains);
+    });
+}
+
+} // namespace bench
@@ -0,0 +1,488 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+#include "bench_storage.h"
+
+#include "ibn_crc32.h"
+#include "ibn_sram_rw.h"
+#include "ibn_sram_wear_leveled_rw.h"
+#include "ibn_storage.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <optional>
+#include <random>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int STORAGE_SIZE = 32 * 1024;
+constexpr int FLASH_ERASE_BLOCK_SIZE = 4 * 1024;
+constexpr int WEAR_LEVELED_SECTORS = STORAGE_SIZE / FLASH_ERASE_BLOCK_SIZE;
+constexpr int SAVE_BYTES = 2000;
+constexpr int SOAK_CYCLES = 4000;
+
+struct save
+{
+    std::uint32_t id = 0;
+    std::array<std::uint8_t, SAVE_BYTES> bytes = {};
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        measurer.write(id);
+        measurer.write(bytes.data(), bytes.size());
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        writer.write(id);
+        writer.write(bytes.data(), bytes.size());
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        reader.read(id);
+        reader.read(bytes.data(), bytes.size());
+    }
+
+    bool operator==(const save&) const = default;
+};
+
+// Same layout as `save`, but declares its schema hash
+struct save_with_schema : save
+{
+    static constexpr std::uint32_t SCHEMA_HASH = ibn::sram_schema_hash("u32 id; u8 bytes[2000]");
+};
+
+// Same layout as `save`, but counts the calls of `read()`
+struct counted_save : save
+{
+    static inline int reads = 0;
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        ++reads;
+        save::read(reader);
+    }
+};
+
+enum class write_kind
+{
+    WRITE,
+    WRITE_SCRATCH,
+    WRITE_STREAMED,
+    WRITE_INCREMENTAL,
+    BACKGROUND,
+
+    COUNT
+};
+
+// Big enough for `save`
+std::array<ibn::bit_stream_writer::word_type, (SAVE_BYTES + 64) / sizeof(ibn::bit_stream_writer::word_type)> scratch;
+
+void write_randomly(ibn::sram_rw& sram, const save& data, std::mt19937& random)
+{
+    switch (write_kind(random() % int(write_kind::COUNT)))
+    {
+    case write_kind::WRITE:
+        sram.write(data);
+        break;
+    case write_kind::WRITE_SCRATCH:
+        sram.write(data, scratch);
+        break;
+    case write_kind::WRITE_STREAMED:
+        sram.write_streamed(data);
+        break;
+    case write_kind::WRITE_INCREMENTAL:
+        sram.write_incremental(data);
+        break;
+    case write_kind::BACKGROUND:
+        sram.begin_write(data);
+        while (!sram.done())
+            sram.update(1 + random() % 512);
+        break;
+    default:
+        break;
+    }
+}
+
+void write_randomly(ibn::sram_wear_leveled_rw& sram, const save& data, std::mt19937&)
+{
+    sram.write(data);
+}
+
+// Writes a save in the legacy format (before the header version), which is a 12-byte header with crc32.
+void write_legacy_save(ibn::storage& storage, int location, const char* magic, std::uint8_t sequence,
+                       const save& data)
+{
+    ibn::bit_stream_measurer measurer;
+    data.measure(measurer);
+    const unsigned data_size = measurer.used_bytes();
+    const unsigned ceiled_data_size = (data_size + 3) / 4 * 4;
+
+    // crc32, magic[5], sequence, data_size (u16), and the data right away
+    std::array<std::uint32_t, 3 + (SAVE_BYTES + 64) / 4> buffer = {};
+    auto* bytes = reinterpret_cast<std::uint8_t*>(buffer.data());
+    std::copy_n(magic, 5, bytes + 4);
+    bytes[9] = sequence;
+    bytes[10] = std::uint8_t(data_size);
+    bytes[11] = std::uint8_t(data_size >> 8);
+
+    ibn::bit_stream_writer writer(bn::span(buffer.data() + 3, ceiled_data_size / 4), data_size);
+    data.write(writer);
+    writer.flush_final();
+
+    buffer[0] = ibn::crc32_fast(bytes + 4, 8 + ceiled_data_size);
+    storage.write(location, bn::span<const std::uint8_t>(bytes, 12 + ceiled_data_size));
+}
+
+bool read_randomly(ibn::sram_rw& sram, save& data, std::mt19937& random)
+{
+    switch (random() % 3)
+    {
+    case 0:
+        return sram.read(data);
+    case 1:
+        return sram.read(data, scratch);
+    default:
+        return sram.read_streamed(data);
+    }
+}
+
+bool read_randomly(ibn::sram_wear_leveled_rw& sram, save& data, std::mt19937&)
+{
+    return sram.read(data);
+}
+
+// Randomized save/load cycles, with power cuts in the middle of some of the saves. \n
+// After a power cut, a fresh instance (i.e. after reboot) must load either the new save or the last committed one.
+// `make(optional, storage)` emplaces a fresh instance on the storage.
+template <typename SaveRw, typename Make>
+void soak(const char* name, int erase_block_size, Make&& make)
+{
+    if (!selected(name))
+        return;
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    memory.fill(erase_block_size > 1 ? 0xFF : 0);
+
+    ibn::memory_storage media(memory, erase_block_size);
+    power_cut_storage storage(media);
+
+    std::mt19937 random(20250101);
+    std::optional<SaveRw> sram;
+    make(sram, storage);
+
+    std::optional<save> committed;
+    save data;
+    int power_cuts = 0, fell_back = 0, mismatches = 0;
+
+    const auto begin = std::chrono::steady_clock::now();
+    for (int cycle = 0; cycle < SOAK_CYCLES; ++cycle)
+    {
+        // Change a few bytes, like a typical progress between saves
+        data.id = cycle + 1;
+        for (int change = random() % 8; change >= 0; --change)
+            data.bytes[random() % SAVE_BYTES] = std::uint8_t(random());
+
+        const bool cut = random() % 4 == 0;
+        if (cut)
+            storage.cut_after(random() % (FLASH_ERASE_BLOCK_SIZE + 64));
+
+        write_randomly(*sram, data, random);
+
+        const bool power_lost = storage.power_cut();
+        storage.restore_power();
+
+        // Reboot after a power cut, otherwise just load with another instance
+        std::optional<SaveRw> loader;
+        make(loader, storage);
+
+        save loaded;
+        const bool success = read_randomly(*loader, loaded, random);
+
+        if (success && loaded == data)
+        {
+            committed = data;
+        }
+        else if (power_lost && (committed ? success && loaded == *committed : !success))
+        {
+            ++fell_back;
+        }
+        else
+        {
+            ++mismatches;
+            committed = success ? std::optional<save>(loaded) : std::nullopt;
+        }
+
+        // Without a reboot, the writer itself must load what it wrote (from its cache, if any)
+        save reloaded;
+        if (!power_lost && (!read_randomly(*sram, reloaded, random) || !(reloaded == data)))
+            ++mismatches;
+
+        if (power_lost)
+        {
+            ++power_cuts;
+            sram.reset();
+            make(sram, storage);
+        }
+    }
+
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("%-40s %12d cycles %6d power cuts %6d fell back %8d erased blocks %8.1f ms\n", name, SOAK_CYCLES,
+                power_cuts, fell_back, media.erased_blocks_count(), elapsed_ms);
+
+    if (mismatches != 0)
+        std::printf("%s: MISMATCH (%d)\n", name, mismatches);
+}
+
+} // namespace
+
+void run_sram_rw_benchmarks()
+{
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    ibn::memory_storage sram_media(memory);
+    ibn::sram_rw sram("IBNBN", 0, STORAGE_SIZE / 2, sram_media);
+
+    save data;
+    for (int i = 0; i < SAVE_BYTES; ++i)
+        data.bytes[i] = std::uint8_t(i * 2654435761u >> 24);
+
+    run("sram_rw/write", SAVE_BYTES, [&] { sram.write(data); });
+    run("sram_rw/write_scratch", SAVE_BYTES, [&] { sram.write(data, scratch); });
+    run("sram_rw/write_streamed", SAVE_BYTES, [&] { sram.write_streamed(data); });
+    run("sram_rw/write_incremental", SAVE_BYTES, [&] {
+        ++data.bytes[0];
+        sram.write_incremental(data);
+    });
+
+    // Reads below need a save, even if the writes above are filtered out
+    sram.write(data);
+
+    if (selected("sram_rw/scan"))
+    {
+        // A fresh instance (i.e. after boot) must find the save without loading it
+        ibn::bit_stream_measurer measurer;
+        data.measure(measurer);
+
+        ibn::sram_rw fresh("IBNBN", 0, STORAGE_SIZE / 2, sram_media);
+        if (!fresh.has_save() || fresh.saved_data_size() != unsigned(measurer.used_bytes()))
+            std::printf("sram_rw/scan: MISMATCH\n");
+    }
+
+    if (selected("sram_rw/schema"))
+    {
+        // A save of another schema must be rejected, even if it deserializes fine
+        ibn::sram_rw fresh("IBNBN", 0, STORAGE_SIZE / 2, sram_media);
+        save_with_schema loaded;
+        if (fresh.saved_schema_hash() != 0 || fresh.read(loaded) || fresh.read(loaded, scratch) ||
+            fresh.read_streamed(loaded))
+            std::printf("sram_rw/schema: MISMATCH\n");
+
+        save_with_schema data_with_schema;
+        static_cast<save&>(data_with_schema) = data;
+        fresh.write_streamed(data_with_schema);
+
+        // Reading without the schema hash skips the recent save, and falls back to the older one
+        save plain;
+        if (fresh.saved_schema_hash() != save_with_schema::SCHEMA_HASH || !fresh.read(loaded) ||
+            !(loaded == data_with_schema) || !fresh.read_streamed(plain) || !(plain == data))
+            std::printf("sram_rw/schema: MISMATCH\n");
+
+        // Restore the save without schema hash for the reads below
+        sram.write(data);
+        sram.write(data);
+    }
+
+    run("sram_rw/scan", SAVE_BYTES * 2, [&] {
+        ibn::sram_rw fresh("IBNBN", 0, STORAGE_SIZE / 2, sram_media);
+        bool has_save = fresh.scan();
+        do_not_optimize(has_save);
+    });
+
+    if (selected("sram_rw/read_scratch"))
+    {
+        // Scratch buffer of exactly `required_scratch_bytes()` must be enough, and one word less must not be
+        const unsigned required_words = ibn::sram_rw::required_scratch_bytes(data) / sizeof(scratch[0]);
+        save loaded;
+        const bool read = sram.read(loaded, bn::span(scratch.data(), int(required_words)));
+        const bool read_short = sram.read(loaded, bn::span(scratch.data(), int(required_words - 1)));
+
+        if (!read || read_short || !(loaded == data))
+            std::printf("sram_rw/read_scratch: MISMATCH\n");
+    }
+
+    save loaded;
+    run("sram_rw/read", SAVE_BYTES, [&] {
+        sram.read(loaded);
+        do_not_optimize(loaded);
+    });
+    run("sram_rw/read_scratch", SAVE_BYTES, [&] {
+        sram.read(loaded, scratch);
+        do_not_optimize(loaded);
+    });
+    run("sram_rw/read_streamed", SAVE_BYTES, [&] {
+        sram.read_streamed(loaded);
+        do_not_optimize(loaded);
+    });
+
+    static std::array<std::uint8_t, STORAGE_SIZE> flash_memory;
+    flash_memory.fill(0xFF);
+    ibn::memory_storage flash_media(flash_memory, FLASH_ERASE_BLOCK_SIZE);
+    ibn::sram_rw flash("IBNBN", 0, STORAGE_SIZE / 2, flash_media);
+
+    run("sram_rw/write_streamed/flash", SAVE_BYTES, [&] { flash.write_streamed(data); });
+
+    if (selected("sram_rw/checksum"))
+    {
+        // A save must be readable with any checksum configured, as the header records the one written with
+        for (int written = 0; written < int(ibn::checksum_kind::COUNT); ++written)
+        {
+            ibn::sram_rw writer("IBNCK", 0, STORAGE_SIZE / 2, sram_media, ibn::checksum_kind(written));
+            writer.write(data);
+            writer.write_incremental(data);
+
+            for (int reading = 0; reading < int(ibn::checksum_kind::COUNT); ++reading)
+            {
+                ibn::sram_rw reader("IBNCK", 0, STORAGE_SIZE / 2, sram_media, ibn::checksum_kind(reading));
+                save loaded;
+                if (!reader.read(loaded) || !(loaded == data) || !reader.read_streamed(loaded) || !(loaded == data))
+                    std::printf("sram_rw/checksum/%d/%d: MISMATCH\n", written, reading);
+            }
+
+            // Corrupted data must be detected
+            memory[sizeof(std::uint32_t) * 8 + 100] ^= 0x10;
+            memory[STORAGE_SIZE / 2 + sizeof(std::uint32_t) * 8 + 100] ^= 0x10;
+
+            ibn::sram_rw reader("IBNCK", 0, STORAGE_SIZE / 2, sram_media);
+            save loaded;
+            if (reader.has_save() || reader.read(loaded) || reader.read_streamed(loaded))
+                std::printf("sram_rw/checksum/%d/corrupted: MISMATCH\n", written);
+        }
+
+        // Restore the save for the reads below
+        sram.write(data);
+        sram.write(data);
+    }
+
+    if (selected("sram_rw/legacy"))
+    {
+        // A save written before the header version must still be read, with every read
+        save older = data;
+        older.id = 3;
+        save legacy = data;
+        legacy.id = 4;
+        write_legacy_save(sram_media, 0, "IBNLG", 6, older);
+        write_legacy_save(sram_media, STORAGE_SIZE / 2, "IBNLG", 7, legacy);
+
+        ibn::sram_rw fresh("IBNLG", 0, STORAGE_SIZE / 2, sram_media);
+        save loaded, loaded_scratch, loaded_streamed;
+        if (!fresh.has_save() || fresh.saved_schema_hash() != 0 || !fresh.read(loaded) || !(loaded == legacy) ||
+            !fresh.read(loaded_scratch, scratch) || !(loaded_scratch == legacy) ||
+            !fresh.read_streamed(loaded_streamed) || !(loaded_streamed == legacy))
+            std::printf("sram_rw/legacy: MISMATCH\n");
+
+        // Writing continues the sequence, and overwrites the older legacy save only
+        save_with_schema migrated;
+        static_cast<save&>(migrated) = data;
+        migrated.id = 5;
+        ibn::sram_rw writer("IBNLG", 0, STORAGE_SIZE / 2, sram_media);
+        writer.read(loaded);
+        writer.write(migrated);
+
+        ibn::sram_rw reloaded("IBNLG", 0, STORAGE_SIZE / 2, sram_media);
+        save_with_schema loaded_migrated;
+        if (!reloaded.read(loaded_migrated) || !(loaded_migrated == migrated) || !reloaded.read(loaded) ||
+            !(loaded == legacy))
+            std::printf("sram_rw/legacy/migrate: MISMATCH\n");
+
+        // Restore the save for the reads below
+        sram.write(data);
+        sram.write(data);
+    }
+
+    if (selected("sram_rw/read_streamed_corrupted"))
+    {
+        // Streamed read never deserializes a corrupted save, so the save data is left untouched by it
+        counted_save older;
+        static_cast<save&>(older) = data;
+        older.id = 1;
+        counted_save recent = older;
+        recent.id = 2;
+        std::ranges::reverse(recent.bytes);
+
+        bool matched = true;
+        for (const int corrupted_location : {0, STORAGE_SIZE / 2, -1})
+        {
+            ibn::sram_rw writer("IBNCR", 0, STORAGE_SIZE / 2, sram_media);
+            writer.write(older);
+            writer.write(recent);
+            if (corrupted_location >= 0)
+            {
+                memory[corrupted_location + SAVE_BYTES - 100] ^= 0x10;
+            }
+            else
+            {
+                memory[SAVE_BYTES - 100] ^= 0x10;
+                memory[STORAGE_SIZE / 2 + SAVE_BYTES - 100] ^= 0x10;
+            }
+
+            ibn::sram_rw reader("IBNCR", 0, STORAGE_SIZE / 2, sram_media);
+            counted_save loaded;
+            loaded.bytes.fill(0xA5);
+            const counted_save untouched = loaded;
+            counted_save::reads = 0;
+            const bool success = reader.read_streamed(loaded);
+
+            if (corrupted_location >= 0)
+                matched = matched && success && counted_save::reads == 1 && (loaded == older || loaded == recent);
+            else
+                matched = matched && !success && counted_save::reads == 0 && loaded == untouched;
+        }
+
+        if (!matched)
+            std::printf("sram_rw/read_streamed_corrupted: MISMATCH\n");
+
+        // Restore the save for the reads below
+        sram.write(data);
+        sram.write(data);
+    }
+
+    const auto run_checksum_write = [&](const char* name, ibn::checksum_kind kind) {
+        ibn::sram_rw writer("IBNBN", 0, STORAGE_SIZE / 2, sram_media, kind);
+        run(name, SAVE_BYTES, [&] { writer.write(data); });
+    };
+    run_checksum_write("sram_rw/write/fletcher32", ibn::checksum_kind::FLETCHER32);
+    run_checksum_write("sram_rw/write/adler32", ibn::checksum_kind::ADLER32);
+    run_checksum_write("sram_rw/write/xxhash32", ibn::checksum_kind::XXHASH32);
+
+    // `sram_rw` erases a location on every save
+    const auto make_sram_rw = [](int erase_block_size, ibn::checksum_kind checksum = ibn::checksum_kind::CRC32) {
+        const unsigned capacity = std::max(ibn::sram_rw::occupied_bytes(SAVE_BYTES + 4), unsigned(erase_block_size));
+        const unsigned distance = (capacity + erase_block_size - 1) / erase_block_size * erase_block_size;
+
+        return [distance, checksum](std::optional<ibn::sram_rw>& sram, ibn::storage& storage) {
+            sram.emplace("IBNSK", 0, distance, storage, checksum);
+            sram->resume_sequence();
+        };
+    };
+    soak<ibn::sram_rw>("sram_rw/soak/sram", 1, make_sram_rw(1));
+    soak<ibn::sram_rw>("sram_rw/soak/flash", FLASH_ERASE_BLOCK_SIZE, make_sram_rw(FLASH_ERASE_BLOCK_SIZE));
+    soak<ibn::sram_rw>("sram_rw/soak/sram/fletcher32", 1, make_sram_rw(1, ibn::checksum_kind::FLETCHER32));
+    soak<ibn::sram_rw>("sram_rw/soak/sram/xxhash32", 1, make_sram_rw(1, ibn::checksum_kind::XXHASH32));
+
+    // `sram_wear_leveled_rw` erases a sector only when it gets full
+    const auto make_wear_leveled_rw = [](std::optional<ibn::sram_wear_leveled_rw>& sram, ibn::storage& storage) {
+        sram.emplace("IBNSK", 0, FLASH_ERASE_BLOCK_SIZE, WEAR_LEVELED_SECTORS, storage);
+    };
+    soak<ibn::sram_wear_leveled_rw>("sram_wear_leveled_rw/soak/sram", 1, make_wear_leveled_rw);
+    soak<ibn::sram_wear_leveled_rw>("sram_wear_leveled_rw/soak/flash", FLASH_ERASE_BLOCK_SIZE, make_wear_leveled_rw);
+}
+
+} // namespace bench
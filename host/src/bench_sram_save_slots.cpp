@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_sram_save_slots.h"
+#include "ibn_storage.h"
+
+#include <array>
+#include <cstdio>
+
+namespace bench
+{
+
+namespace
+{
+
+constexpr int STORAGE_SIZE = 32 * 1024;
+constexpr unsigned DIRECTORY_CAPACITY = 256;
+constexpr unsigned SLOT_CAPACITY = 1024;
+constexpr int SLOTS = 3;
+
+struct summary
+{
+    std::uint32_t play_frames = 0;
+    std::uint8_t chapter = 0;
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        measurer.write(play_frames).write(chapter);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        writer.write(play_frames).write(chapter);
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        reader.read(play_frames).read(chapter);
+    }
+
+    bool operator==(const summary&) const = default;
+};
+
+// Reads more than `summary` wrote, so it can't load the directory of `summary`
+struct summary_v2 : summary
+{
+    std::uint16_t deaths = 0;
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        summary::measure(measurer);
+        measurer.write(deaths);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        summary::write(writer);
+        writer.write(deaths);
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        summary::read(reader);
+        reader.read(deaths);
+    }
+
+    bool operator==(const summary_v2&) const = default;
+};
+
+struct progress
+{
+    std::array<std::uint16_t, 64> flags = {};
+
+    void measure(ibn::bit_stream_measurer& measurer) const
+    {
+        for (const std::uint16_t flag : flags)
+            measurer.write(flag);
+    }
+
+    void write(ibn::bit_stream_writer& writer) const
+    {
+        for (const std::uint16_t flag : flags)
+            writer.write(flag);
+    }
+
+    void read(ibn::bit_stream_reader& reader)
+    {
+        for (std::uint16_t& flag : flags)
+            reader.read(flag);
+    }
+
+    bool operator==(const progress&) const = default;
+};
+
+// Same layout as `progress`, but declares another schema
+struct progress_v2 : progress
+{
+    static constexpr std::uint32_t SCHEMA_HASH = ibn::sram_schema_hash("u16 flags[64] v2");
+};
+
+template <typename Summary = summary>
+auto make_slots(ibn::storage& storage) -> ibn::sram_save_slots<Summary, SLOTS>
+{
+    return ibn::sram_save_slots<Summary, SLOTS>("IBNSS", 0, DIRECTORY_CAPACITY, SLOT_CAPACITY, storage);
+}
+
+auto make_progress(std::uint16_t seed) -> progress
+{
+    progress result;
+    for (int index = 0; index < int(result.flags.size()); ++index)
+        result.flags[index] = std::uint16_t(seed * 31 + index);
+    return result;
+}
+
+void check_sram_save_slots()
+{
+    if (!selected("sram_save_slots/check"))
+        return;
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    memory.fill(0);
+    ibn::memory_storage storage(memory);
+
+    // Nothing to load yet
+    {
+        auto slots = make_slots(storage);
+        progress loaded;
+        if (slots.load_directory() || slots.has_save(0) || slots.read(0, loaded))
+            std::printf("sram_save_slots/check/empty: MISMATCH\n");
+    }
+
+    // Slots and their summaries
+    {
+        auto slots = make_slots(storage);
+        slots.load_directory();
+        slots.write(0, make_progress(0), summary{100, 1});
+        slots.write(2, make_progress(2), summary{300, 3});
+        slots.write(0, make_progress(10), summary{1000, 2});
+
+        auto reloaded = make_slots(storage);
+        progress loaded_0, loaded_1, loaded_2;
+        if (!reloaded.load_directory() || !reloaded.has_save(0) || reloaded.has_save(1) || !reloaded.has_save(2) ||
+            reloaded.summary(0) != summary{1000, 2} || reloaded.summary(2) != summary{300, 3} ||
+            !reloaded.read(0, loaded_0) || loaded_0 != make_progress(10) || reloaded.read(1, loaded_1) ||
+            !reloaded.read(2, loaded_2) || loaded_2 != make_progress(2))
+            std::printf("sram_save_slots/check/slots: MISMATCH\n");
+    }
+
+    // Erasing only empties the directory entry
+    {
+        auto slots = make_slots(storage);
+        slots.load_directory();
+        slots.erase(2);
+
+        auto reloaded = make_slots(storage);
+        progress loaded;
+        if (!reloaded.load_directory() || !reloaded.has_save(0) || reloaded.has_save(2) || reloaded.read(2, loaded))
+            std::printf("sram_save_slots/check/directory: MISMATCH\n");
+    }
+
+    // Failed read doesn't skip the scan, so the next write is still the recent one
+    {
+        auto slots = make_slots(storage);
+        progress_v2 other;
+        if (!slots.load_directory() || slots.read(0, other))
+            std::printf("sram_save_slots/check/failed_read: MISMATCH\n");
+        slots.write(0, make_progress(20), summary{2000, 4});
+
+        auto reloaded = make_slots(storage);
+        progress loaded;
+        if (!reloaded.load_directory() || !reloaded.read(0, loaded) || loaded != make_progress(20))
+            std::printf("sram_save_slots/check/failed_read/write: MISMATCH\n");
+    }
+
+    // Failed directory load doesn't skip the scan either, so the recent directory isn't overwritten
+    {
+        auto slots = make_slots<summary_v2>(storage);
+        if (slots.load_directory() || slots.has_save(0))
+            std::printf("sram_save_slots/check/failed_directory: MISMATCH\n");
+        slots.write(1, make_progress(1), summary_v2{{10, 1}, 5});
+
+        auto reloaded = make_slots<summary_v2>(storage);
+        progress loaded;
+        if (!reloaded.load_directory() || reloaded.has_save(0) || !reloaded.has_save(1) ||
+            reloaded.summary(1) != summary_v2{{10, 1}, 5} || !reloaded.read(1, loaded) || loaded != make_progress(1))
+            std::printf("sram_save_slots/check/failed_directory/write: MISMATCH\n");
+
+        // The older location still has the recent directory of `summary`
+        auto previous = make_slots(storage);
+        if (!previous.load_directory() || previous.summary(0) != summary{2000, 4})
+            std::printf("sram_save_slots/check/failed_directory/previous: MISMATCH\n");
+    }
+}
+
+} // namespace
+
+void run_sram_save_slots_benchmarks()
+{
+    check_sram_save_slots();
+
+    static std::array<std::uint8_t, STORAGE_SIZE> memory;
+    static ibn::memory_storage storage(memory);
+    static auto slots = make_slots(storage);
+    static const progress data = make_progress(1);
+    progress loaded;
+    slots.write(1, data, summary{1, 1});
+
+    run("sram_save_slots/load_directory", 0, [&] {
+        bool loaded_directory = slots.load_directory();
+        do_not_optimize(loaded_directory);
+    });
+
+    run("sram_save_slots/read", 0, [&] {
+        bool read = slots.read(1, loaded);
+        do_not_optimize(read);
+        do_not_optimize(loaded);
+    });
+}
+
+} // namespace bench
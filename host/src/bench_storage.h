@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+// Storage helpers shared by the save benchmarks.
+
+#pragma once
+
+#include "ibn_storage.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace bench
+{
+
+// Drops every write & erase after the byte budget is used up, like a power loss in the middle of saving.
+class power_cut_storage final : public ibn::storage
+{
+public:
+    explicit power_cut_storage(ibn::storage& storage) : _storage(storage)
+    {
+    }
+
+    void cut_after(int bytes)
+    {
+        _budget = bytes;
+    }
+
+    void restore_power()
+    {
+        _budget.reset();
+    }
+
+    bool power_cut() const
+    {
+        return _budget.has_value() && *_budget == 0;
+    }
+
+    auto size() const -> int override
+    {
+        return _storage.size();
+    }
+
+    auto erase_block_size() const -> int override
+    {
+        return _storage.erase_block_size();
+    }
+
+    void read(int offset, bn::span<std::uint8_t> bytes) override
+    {
+        _storage.read(offset, bytes);
+    }
+
+    void write(int offset, bn::span<const std::uint8_t> bytes) override
+    {
+        _storage.write(offset, bytes.first(consume(bytes.size())));
+    }
+
+    void erase(int offset, int size) override
+    {
+        // Erase blocks are erased one by one, each of which costs a byte of the budget
+        const int block_size = _storage.erase_block_size();
+        const int blocks = consume(size / block_size);
+        if (blocks > 0)
+            _storage.erase(offset, blocks * block_size);
+    }
+
+private:
+    // Returns the number of units done before the power is cut.
+    auto consume(int units) -> int
+    {
+        if (!_budget.has_value())
+            return units;
+
+        const int done = std::clamp(*_budget, 0, units);
+        *_budget -= done;
+        return done;
+    }
+
+private:
+    ibn::storage& _storage;
+    std::optional<int> _budget;
+};
+
+} // namespace bench
@@ -0,0 +1,335 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_function.h"
+#include "ibn_generator.h"
+#include "ibn_task.h"
+#include "ibn_task_scheduler.h"
+
+#include <bn_timer.h>
+
+#include <coroutine>
+#include <cstdio>
+#include <vector>
+
+namespace bench
+{
+
+namespace
+{
+
+auto endless_task(int& counter) -> ibn::lazy_task<void>
+{
+    while (true)
+    {
+        ++counter;
+        co_await std::suspend_always{};
+    }
+}
+
+auto leaf_task(int value) -> ibn::lazy_task<int>
+{
+    co_return value + 1;
+}
+
+auto parent_task(int value) -> ibn::lazy_task<int>
+{
+    const int result = co_await leaf_task(value);
+    co_return result * 2;
+}
+
+// Logs `id` on each resume, for `times` resumes
+auto logging_task(std::vector<int>& log, int id, int times) -> ibn::lazy_task<void>
+{
+    for (int resume = 0; resume < times; ++resume)
+    {
+        log.push_back(id);
+        co_await std::suspend_always{};
+    }
+}
+
+// Spins for `ticks` on each resume, while `spinning` is set
+auto spinning_task(const bool& spinning, int ticks) -> ibn::lazy_task<void>
+{
+    while (true)
+    {
+        bn::timer timer;
+        while (spinning && timer.elapsed_ticks() < ticks)
+        {
+        }
+        co_await std::suspend_always{};
+    }
+}
+
+auto cancelling_task(ibn::task_scheduler& scheduler, ibn::task_scheduler::task_id& self, int& counter)
+    -> ibn::lazy_task<void>
+{
+    ++counter;
+    scheduler.cancel(self);
+    co_await std::suspend_always{};
+    ++counter;
+}
+
+// Cancels the sibling on its first resume, and then logs `id` for `times` resumes
+auto sibling_cancelling_task(ibn::task_scheduler& scheduler, const ibn::task_scheduler::task_id& sibling,
+                             std::vector<int>& log, int id, int times) -> ibn::lazy_task<void>
+{
+    scheduler.cancel(sibling);
+    for (int resume = 0; resume < times; ++resume)
+    {
+        log.push_back(id);
+        co_await std::suspend_always{};
+    }
+}
+
+// Logs the frame on each wake up
+auto sleeping_child(std::vector<unsigned>& log, int frames_count) -> ibn::lazy_task<int>
+{
+    co_await ibn::frames(frames_count);
+    log.push_back(ibn::task_scheduler::current()->frame());
+    co_await ibn::next_frame();
+    log.push_back(ibn::task_scheduler::current()->frame());
+    co_return frames_count;
+}
+
+auto sleeping_parent(std::vector<unsigned>& log, const int& flag) -> ibn::lazy_task<void>
+{
+    const int slept = co_await sleeping_child(log, 3);
+    co_await ibn::frames(slept);
+    log.push_back(ibn::task_scheduler::current()->frame());
+    co_await ibn::frames(0);
+    co_await ibn::until([&flag] { return flag != 0; });
+    log.push_back(ibn::task_scheduler::current()->frame());
+}
+
+auto sleeping_task(int& counter, int frames_count) -> ibn::lazy_task<void>
+{
+    while (true)
+    {
+        ++counter;
+        co_await ibn::frames(frames_count);
+    }
+}
+
+void check_task_scheduler()
+{
+    if (!selected("task_scheduler/check"))
+        return;
+
+    // Priority order, then spawn order; completed tasks are destroyed
+    {
+        ibn::task_scheduler scheduler(8, 3);
+        std::vector<int> log;
+        scheduler.spawn(logging_task(log, 20, 2), 2);
+        scheduler.spawn(logging_task(log, 0, 1), 0);
+        scheduler.spawn(logging_task(log, 10, 2), 1);
+        scheduler.spawn(logging_task(log, 1, 2), 0);
+
+        scheduler.update();
+        scheduler.update();
+        scheduler.update();
+        scheduler.update();
+
+        if (log != std::vector<int>{0, 1, 10, 20, 1, 10, 20} || scheduler.tasks_count() != 0)
+            std::printf("task_scheduler/check/order: MISMATCH\n");
+    }
+
+    // Cancel others and itself, and stale ids
+    {
+        ibn::task_scheduler scheduler(4);
+        std::vector<int> log;
+        const auto other = scheduler.spawn(logging_task(log, 1, 100), 1);
+        int counter = 0;
+        ibn::task_scheduler::task_id self;
+        self = scheduler.spawn(cancelling_task(scheduler, self, counter), 1);
+
+        scheduler.update();
+        scheduler.cancel(other);
+        scheduler.update();
+
+        const auto reused = scheduler.spawn(logging_task(log, 2, 1), 1);
+        scheduler.cancel(other);
+        scheduler.cancel(self);
+
+        if (counter != 1 || scheduler.contains(other) || scheduler.contains(self) || !scheduler.contains(reused) ||
+            log != std::vector<int>{1})
+            std::printf("task_scheduler/check/cancel: MISMATCH\n");
+    }
+
+    // Cancelling a sibling queued behind doesn't resume the others twice, whether the canceller keeps running or not
+    for (const int times : {100, 0})
+    {
+        ibn::task_scheduler scheduler(4);
+        std::vector<int> log;
+        ibn::task_scheduler::task_id sibling;
+        scheduler.spawn(sibling_cancelling_task(scheduler, sibling, log, 1, times), 1);
+        sibling = scheduler.spawn(logging_task(log, 2, 100), 1);
+
+        scheduler.update();
+        scheduler.update();
+
+        const std::vector<int> expected = times ? std::vector<int>{1, 1} : std::vector<int>{};
+        if (log != expected || scheduler.contains(sibling) || scheduler.tasks_count() != (times ? 1 : 0))
+            std::printf("task_scheduler/check/cancel_sibling/%s: MISMATCH\n", times ? "running" : "completes");
+    }
+
+    // Budget defers the lower priorities, but never the highest one
+    {
+        ibn::task_scheduler scheduler(8, 2);
+        scheduler.set_frame_budget_ticks(1);
+        bool spinning = true;
+        std::vector<int> log;
+        scheduler.spawn(spinning_task(spinning, 2), 0);
+        scheduler.spawn(spinning_task(spinning, 2), 0);
+        scheduler.spawn(logging_task(log, 1, 100), 1);
+        scheduler.spawn(logging_task(log, 2, 100), 1);
+
+        scheduler.update();
+        const bool deferred = scheduler.last_deferred_count() == 2 && log.empty();
+
+        spinning = false;
+        scheduler.update();
+
+        if (!deferred || scheduler.last_deferred_count() != 0 || log != std::vector<int>{1, 2})
+            std::printf("task_scheduler/check/budget: MISMATCH\n");
+    }
+
+    // Awaitables, including from a nested task
+    {
+        ibn::task_scheduler scheduler(4);
+        std::vector<unsigned> log;
+        int flag = 0;
+        scheduler.spawn(sleeping_parent(log, flag), 1);
+
+        for (int frame = 1; frame <= 20; ++frame)
+        {
+            flag = (frame >= 15);
+            scheduler.update();
+        }
+
+        if (log != std::vector<unsigned>{4, 5, 8, 15} || scheduler.tasks_count() != 0)
+            std::printf("task_scheduler/check/awaitables: MISMATCH\n");
+    }
+
+    // Sleeping tasks wake up in order, and can be cancelled
+    {
+        ibn::task_scheduler scheduler(64);
+        std::vector<int> counters(64);
+        std::vector<ibn::task_scheduler::task_id> ids;
+        for (int task = 0; task < 64; ++task)
+            ids.push_back(scheduler.spawn(sleeping_task(counters[task], 1 + task), task % 4));
+
+        for (int task = 0; task < 64; task += 2)
+            scheduler.cancel(ids[task]);
+
+        for (int frame = 0; frame < 1000; ++frame)
+            scheduler.update();
+
+        for (int task = 0; task < 64; ++task)
+            if (counters[task] != ((task % 2 == 0) ? 0 : 1 + 999 / (1 + task)))
+            {
+                std::printf("task_scheduler/check/sleep: MISMATCH\n");
+                break;
+            }
+    }
+
+    // Long sleeps, across the levels of the timer wheel
+    {
+        constexpr int FRAMES = 150000;
+        constexpr int SLEEPS[] = {2, 63, 64, 65, 4095, 4096, 4097, 70000};
+        constexpr int TASKS = sizeof(SLEEPS) / sizeof(SLEEPS[0]);
+
+        ibn::task_scheduler scheduler(TASKS + 1);
+        std::vector<int> counters(TASKS + 1);
+        for (int task = 0; task < TASKS; ++task)
+            scheduler.spawn(sleeping_task(counters[task], SLEEPS[task]), 1);
+
+        // Cancelled while it sleeps in a higher level
+        const auto cancelled = scheduler.spawn(sleeping_task(counters[TASKS], 5000), 1);
+
+        for (int frame = 1; frame <= FRAMES; ++frame)
+        {
+            if (frame == 7000)
+                scheduler.cancel(cancelled);
+            scheduler.update();
+        }
+
+        bool matched = counters[TASKS] == 2 && scheduler.tasks_count() == TASKS;
+        for (int task = 0; task < TASKS; ++task)
+            matched = matched && counters[task] == 1 + (FRAMES - 1) / SLEEPS[task];
+
+        if (!matched)
+            std::printf("task_scheduler/check/long_sleep: MISMATCH\n");
+    }
+}
+
+auto counting_generator(int count) -> ibn::generator<int>
+{
+    for (int i = 0; i < count; ++i)
+        co_yield i;
+}
+
+} // namespace
+
+void run_task_benchmarks()
+{
+    int counter = 0;
+    auto endless = endless_task(counter);
+
+    run("task/resume", 0, [&] {
+        endless.resume();
+        do_not_optimize(counter);
+    });
+
+    run("task/create_resume_destroy", 0, [&] {
+        auto task = leaf_task(counter);
+        task.resume();
+        int result = task.result();
+        do_not_optimize(result);
+    });
+
+    run("task/co_await_nested", 0, [&] {
+        auto task = parent_task(counter);
+        task.resume();
+        int result = task.result();
+        do_not_optimize(result);
+    });
+
+    check_task_scheduler();
+
+    static ibn::task_scheduler scheduler(256);
+    for (int task = 0; task < scheduler.max_tasks(); ++task)
+        scheduler.spawn(endless_task(counter), task % scheduler.priorities_count());
+
+    run("task_scheduler/update_256", 0, [&] {
+        scheduler.update();
+        do_not_optimize(counter);
+    });
+
+    // Sleeping tasks should be nearly free
+    static ibn::task_scheduler sleeping_scheduler(256);
+    for (int task = 0; task < sleeping_scheduler.max_tasks(); ++task)
+        sleeping_scheduler.spawn(sleeping_task(counter, 1000 + task), task % sleeping_scheduler.priorities_count());
+
+    run("task_scheduler/update_256_sleeping", 0, [&] {
+        sleeping_scheduler.update();
+        do_not_optimize(counter);
+    });
+
+    run("generator/iterate_1024", 0, [&] {
+        int sum = 0;
+        for (int value : counting_generator(1024))
+            sum += value;
+        do_not_optimize(sum);
+    });
+
+    ibn::function<int(int)> function = [&counter](int value) { return value + counter; };
+    run("function/invoke", 0, [&] {
+        int result = function(counter);
+        do_not_optimize(result);
+    });
+}
+
+} // namespace bench
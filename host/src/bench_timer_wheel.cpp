@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+#include "ibn_timer_wheel.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace bench
+{
+
+namespace
+{
+
+struct timer final : public ibn::timer_wheel_node
+{
+    int expired_count = 0;
+};
+
+// Adds and removes at random, and checks every node expires exactly on its frame
+template <int SlotBits, int Levels>
+void check_timer_wheel(const char* name, unsigned max_delay)
+{
+    constexpr int NODES = 256;
+    constexpr int FRAMES = 200000;
+
+    std::mt19937 random(20250101);
+    // Outlives the wheel, which unlinks the nodes left
+    std::vector<timer> timers(NODES);
+    ibn::timer_wheel<timer, SlotBits, Levels> wheel;
+    int added = 0;
+    bool matched = true;
+
+    for (int frame = 0; frame < FRAMES && matched; ++frame)
+    {
+        timer& node = timers[random() % NODES];
+        if (!node.in_wheel())
+        {
+            wheel.add(node, wheel.now() + 1 + random() % max_delay);
+            ++added;
+        }
+        else if (random() % 4 == 0)
+        {
+            wheel.remove(node);
+            --added;
+        }
+
+        wheel.advance([&](timer& expired) {
+            matched = matched && expired.expiry() == wheel.now() && !expired.in_wheel();
+            ++expired.expired_count;
+            --added;
+        });
+
+        // Nothing left behind
+        for (const timer& pending : timers)
+            if (pending.in_wheel() && int(pending.expiry() - wheel.now()) <= 0)
+                matched = false;
+    }
+
+    if (!matched || added != wheel.size())
+        std::printf("timer_wheel/check/%s: MISMATCH\n", name);
+}
+
+} // namespace
+
+void run_timer_wheel_benchmarks()
+{
+    if (selected("timer_wheel/check"))
+    {
+        // Small wheel, which covers only 64 frames
+        check_timer_wheel<2, 3>("small", 300);
+        check_timer_wheel<6, 4>("default", 20000);
+    }
+
+    // Mostly sleeping, like enemy AI scripts
+    constexpr int NODES = 1024;
+    static std::vector<timer> timers(NODES);
+    static ibn::timer_wheel<timer> wheel;
+    std::mt19937 random(20250101);
+    for (timer& node : timers)
+        wheel.add(node, wheel.now() + 60 + random() % 600);
+
+    run("timer_wheel/advance_1024", 0, [&] {
+        wheel.advance([&](timer& expired) { wheel.add(expired, wheel.now() + 60 + random() % 600); });
+        do_not_optimize(wheel);
+    });
+
+    run("timer_wheel/add_remove", 0, [&] {
+        timer& node = timers[random() % NODES];
+        const unsigned expiry = node.expiry();
+        wheel.remove(node);
+        wheel.add(node, expiry);
+        do_not_optimize(node);
+    });
+}
+
+} // namespace bench
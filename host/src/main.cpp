@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "bench.h"
+
+namespace bench
+{
+
+namespace
+{
+
+std::string_view filter;
+
+} // namespace
+
+bool selected(std::string_view name)
+{
+    return name.find(filter) != std::string_view::npos;
+}
+
+} // namespace bench
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+        bench::filter = argv[1];
+
+    bench::run_bit_stream_benchmarks();
+    bench::run_crc32_benchmarks();
+    bench::run_checksum_benchmarks();
+    bench::run_task_benchmarks();
+    bench::run_timer_wheel_benchmarks();
+    bench::run_observer_benchmarks();
+    bench::run_sram_rw_benchmarks();
+    bench::run_sram_journal_benchmarks();
+    bench::run_sram_kv_store_benchmarks();
+    bench::run_sram_save_slots_benchmarks();
+}
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "ibn_code_iwram.h"
 #include "ibn_make_unsigned_allow_bool.h"
 
 #include <bn_fixed.h>
@@ -17,6 +18,17 @@
 #include <limits>
 #include <type_traits>
 
+#ifndef IBN_CFG_BIT_STREAM_IWRAM
+#define IBN_CFG_BIT_STREAM_IWRAM false
+#endif
+
+#if IBN_CFG_BIT_STREAM_IWRAM
+// Placement of the word flush & fetch functions.
+#define IBN_BIT_STREAM_CODE IBN_CODE_IWRAM_ARM
+#else
+#define IBN_BIT_STREAM_CODE
+#endif
+
 #define IBN_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(ret_val) \
     do \
     { \
@@ -78,6 +90,8 @@
 namespace ibn
 {
 
+class bit_stream_sink;
+
 /// @brief Helper stream to write bits to your buffer.
 ///
 /// Its design is based on the articles by Glenn Fiedler, see:
@@ -130,6 +144,9 @@ private:
 
     bool _final_flushed;
 
+    // Chunked mode: `_words` is a chunk buffer drained to `_sink` whenever it gets full.
+    bit_stream_sink* _sink;
+
 public:
     /// @brief Deleted copy constructor.
     bit_stream_writer(const bit_stream_writer&) = delete;
@@ -163,6 +180,16 @@ public:
     /// This is useful if you want to only allow partial write to the final word.
     bit_stream_writer(word_type* begin, size_type words_length, size_type logical_bytes_length);
 
+    /// @brief Constructs a chunked `bit_stream_writer` instance, which drains its chunk buffer to a sink.
+    ///
+    /// Whenever the @p chunk_buffer gets full, the flushed words are passed to the @p sink,
+    /// and the stream starts over from the beginning of the @p chunk_buffer. \n
+    /// This way, a stream much larger than the @p chunk_buffer can be written with a small memory footprint.
+    /// @param chunk_buffer Buffer to temporarily write bits to.
+    /// @param logical_bytes_length Number of bytes logically, which can be larger than the @p chunk_buffer.
+    /// @param sink Sink to drain the @p chunk_buffer to.
+    bit_stream_writer(bn::span<word_type> chunk_buffer, size_type logical_bytes_length, bit_stream_sink& sink);
+
 public:
     /// @brief Force set the fail flag.
     void set_fail()
@@ -274,6 +301,14 @@ public:
     /// This is useful if you want to only allow partial write to the final word.
     void reset_with(word_type* begin, size_type words_length, size_type logical_bytes_length);
 
+    /// @brief Resets the stream with a chunk buffer and a sink to drain it to.
+    /// @note This function resets to the new buffer @b without flushing to your previous buffer, \n
+    /// so if you need flushing, you should call `flush_final()` beforehand.
+    /// @param chunk_buffer Buffer to temporarily write bits to.
+    /// @param logical_bytes_length Number of bytes logically, which can be larger than the @p chunk_buffer.
+    /// @param sink Sink to drain the @p chunk_buffer to.
+    void reset_with(bn::span<word_type> chunk_buffer, size_type logical_bytes_length, bit_stream_sink& sink);
+
     /// @brief Flushes the last remaining bytes on the internal scratch buffer to your buffer.
     /// @note This function must be only called when you're done writing. \n
     /// Any attempt to write more data after calling this function will set the fail flag and write nothing.
@@ -508,7 +543,7 @@ private:
     }
 
 private:
-    void flush_if_scratch_overflow();
+    IBN_BIT_STREAM_CODE void flush_if_scratch_overflow();
 
     /// @brief Actually flushes from the internal scratch buffer to the user buffer.
     /// @note This function flushes the internal scratch word as-is, \n
@@ -516,7 +551,37 @@ private:
     /// write some undesired additional `0` bits in the middle of your buffer. \n
     /// To avoid that, you should only call this when you're done writing everything.
     /// @return The stream itself.
-    void do_flush_word_unchecked();
+    IBN_BIT_STREAM_CODE void do_flush_word_unchecked();
+};
+
+/// @brief Destination of the words flushed by a chunked `bit_stream_writer`.
+class bit_stream_sink
+{
+public:
+    virtual ~bit_stream_sink() = default;
+
+    /// @brief Consumes the words flushed to the chunk buffer.
+    ///
+    /// This is called whenever the chunk buffer gets full, and once more on `bit_stream_writer::flush_final()`
+    /// if there are remaining words.
+    /// @param words Flushed words, which are only valid until this function returns.
+    virtual void consume(bn::span<const bit_stream_writer::word_type> words) = 0;
+};
+
+/// @brief Origin of the words fetched by a chunked `bit_stream_reader`.
+class bit_stream_source
+{
+public:
+    virtual ~bit_stream_source() = default;
+
+    /// @brief Fetches the words to the chunk buffer.
+    ///
+    /// This is called whenever the chunk buffer is exhausted, with the @p first_word_index right after it. \n
+    /// But `bit_stream_reader::skip()` and `bit_stream_reader::peek_string_length()` might jump to any word.
+    /// @param first_word_index Index of the first word to fetch, counted from the beginning of the stream.
+    /// @param words Chunk buffer to fetch to. \n
+    /// Only the words within the logical length of the stream are read, so the words past it can be left as-is.
+    virtual void fetch(bit_stream_writer::size_type first_word_index, bn::span<bit_stream_writer::word_type> words) = 0;
 };
 
 /// @brief Measures the bytes `bit_stream_writer` will use.
@@ -679,6 +744,10 @@ private:
     bool _init_fail;
     bool _fail;
 
+    // Chunked mode: `_words` is a chunk buffer fetched from `_source`, starting from `_words_base`-th word.
+    bit_stream_source* _source;
+    size_type _words_base;
+
 public:
     /// @brief Deleted copy constructor.
     bit_stream_reader(const bit_stream_reader&) = delete;
@@ -712,6 +781,15 @@ public:
     /// This is useful if you want to only allow partial read from the final word.
     bit_stream_reader(const word_type* begin, size_type words_length, size_type logical_bytes_length);
 
+    /// @brief Constructs a chunked `bit_stream_reader` instance, which fetches its chunk buffer from a source.
+    ///
+    /// Whenever the @p chunk_buffer is exhausted, the next words are fetched from the @p source to it. \n
+    /// This way, a stream much larger than the @p chunk_buffer can be read with a small memory footprint.
+    /// @param chunk_buffer Buffer to temporarily fetch words to.
+    /// @param logical_bytes_length Number of bytes logically, which can be larger than the @p chunk_buffer.
+    /// @param source Source to fetch the words from.
+    bit_stream_reader(bn::span<word_type> chunk_buffer, size_type logical_bytes_length, bit_stream_source& source);
+
 public:
     /// @brief Force set the fail flag.
     void set_fail()
@@ -813,6 +891,12 @@ public:
     /// This is useful if you want to only allow partial read from the final word.
     void reset_with(const word_type* begin, size_type words_length, size_type logical_bytes_length);
 
+    /// @brief Resets the stream with a chunk buffer and a source to fetch it from.
+    /// @param chunk_buffer Buffer to temporarily fetch words to.
+    /// @param logical_bytes_length Number of bytes logically, which can be larger than the @p chunk_buffer.
+    /// @param source Source to fetch the words from.
+    void reset_with(bn::span<word_type> chunk_buffer, size_type logical_bytes_length, bit_stream_source& source);
+
 public:
     /// @brief Reads some arbitrary data from the bit stream.
     /// @param data Pointer to the arbitrary data.
@@ -959,6 +1043,14 @@ public:
     /// @return Length of characters stored in it, or a negative value if length prefix is invalid.
     auto peek_string_length() -> ssize_type;
 
+    /// @brief Skips some bits from the current stream position, without reading them.
+    ///
+    /// This takes a constant time regardless of @p bits. \n
+    /// If it skips past the end of the stream, this function will set the fail flag and skip nothing.
+    /// @param bits Number of bits to skip.
+    /// @return The stream itself.
+    auto skip(size_type bits) -> bit_stream_reader&;
+
 private:
     /// @brief Reads the string length prefix from the current stream position.
     ///
@@ -1013,7 +1105,7 @@ private:
         _scratch_bits -= bits;
 
         // Convert to original range.
-        const SInt conv = static_cast<SInt>(((SInt)value) + min);
+        const SInt conv = static_cast<SInt>(static_cast<UInt>(value + ((UInt)min))); // Wraps, instead of overflowing
 
         if constexpr (Checked)
         {
@@ -1099,7 +1191,7 @@ private:
         }
 
         // Convert to original range.
-        const BInt conv = static_cast<BInt>(((BInt)value) + min);
+        const BInt conv = static_cast<BInt>(static_cast<UInt>(value + ((UInt)min))); // Wraps, instead of overflowing
 
         if constexpr (Checked)
         {
@@ -1121,7 +1213,10 @@ private:
     }
 
 private:
-    void do_fetch_word_unchecked();
+    IBN_BIT_STREAM_CODE void do_fetch_word_unchecked();
+
+    // Fetches the chunk buffer from `_source`, starting from the `first_word_index`-th word.
+    void fetch_chunk(size_type first_word_index);
 };
 
 } // namespace ibn
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_bit_stream.h"
+
+#include <concepts>
+#include <cstdint>
+
+namespace ibn
+{
+
+/// @brief Header of a section framed in a bit stream.
+///
+/// Each section is written as `[id][version][bits][payload]`,
+/// so that the reader can skip unknown or obsolete sections in O(1),
+/// and run the migrations only on the sections whose version changed.
+struct bit_stream_section_header final
+{
+    using size_type = bit_stream_writer::size_type;
+
+    /// @brief Number of bits a section header occupies in the stream.
+    static constexpr size_type BITS = 8 * (sizeof(std::uint16_t) + sizeof(std::uint8_t) + sizeof(size_type));
+
+    std::uint16_t id;
+    std::uint8_t version;
+    size_type bits; ///< Number of bits of the payload, excluding the header itself.
+};
+
+/// @brief Payload of a section that can be measured and written.
+template <typename T>
+concept bit_stream_section_data = requires(const T& data, bit_stream_measurer& measurer, bit_stream_writer& writer) {
+    { data.measure(measurer) } -> std::same_as<void>;
+    { data.write(writer) } -> std::same_as<void>;
+};
+
+/// @brief Fake-writes a section (header + payload) to the measurer.
+/// @param measurer Measurer to fake-write to.
+/// @param data Payload of the section.
+template <bit_stream_section_data Data>
+void measure_section(bit_stream_measurer& measurer, const Data& data)
+{
+    measurer.write(std::uint16_t(0));
+    measurer.write(std::uint8_t(0));
+    measurer.write(bit_stream_section_header::size_type(0));
+
+    data.measure(measurer);
+}
+
+/// @brief Writes a section (header + payload) to the bit stream.
+///
+/// If the payload writes a different number of bits from what it measured, \n
+/// this function will set the fail flag, as the section can't be skipped correctly on read.
+/// @param writer Stream to write to.
+/// @param id Id of the section.
+/// @param version Version of the section payload.
+/// @param data Payload of the section.
+template <bit_stream_section_data Data>
+void write_section(bit_stream_writer& writer, std::uint16_t id, std::uint8_t version, const Data& data)
+{
+    bit_stream_measurer measurer;
+    data.measure(measurer);
+
+    writer.write(id).write(version).write(measurer.used_bits());
+
+    const auto payload_begin = writer.used_bits();
+    data.write(writer);
+
+    if (writer && writer.used_bits() - payload_begin != measurer.used_bits())
+        writer.set_fail();
+}
+
+/// @brief Reads the next section header from the bit stream.
+/// @param reader Stream to read from.
+/// @param header Header to read to.
+/// @return Whether the header has been read or not.
+bool read_section_header(bit_stream_reader& reader, bit_stream_section_header& header);
+
+/// @brief Skips the payload of the section, without reading it.
+///
+/// This takes a constant time regardless of the payload size.
+/// @param reader Stream positioned right after the @p header.
+/// @param header Header of the section to skip.
+/// @return Whether the payload has been skipped or not.
+bool skip_section(bit_stream_reader& reader, const bit_stream_section_header& header);
+
+/// @brief Reads the payload of the section with @p read_payload.
+///
+/// After @p read_payload returns, the remaining payload bits (e.g. fields appended by a newer writer) are skipped. \n
+/// If @p read_payload reads past the payload, this function will set the fail flag.
+///
+/// @code{.cpp}
+/// ibn::bit_stream_section_header header;
+/// while (reader.unused_bits() >= header.BITS && ibn::read_section_header(reader, header))
+/// {
+///     if (header.id == PLAYER_SECTION_ID)
+///         ibn::read_section(reader, header, [&](ibn::bit_stream_reader& r) { player.read(r, header.version); });
+///     else
+///         ibn::skip_section(reader, header);
+/// }
+/// @endcode
+/// @param reader Stream positioned right after the @p header.
+/// @param header Header of the section to read.
+/// @param read_payload Callable that reads the payload, invoked with @p reader.
+/// @return Whether the payload has been read or not.
+template <typename ReadPayload>
+    requires std::invocable<ReadPayload&, bit_stream_reader&>
+bool read_section(bit_stream_reader& reader, const bit_stream_section_header& header, ReadPayload&& read_payload)
+{
+    if (!reader)
+        return false;
+
+    const auto payload_begin = reader.used_bits();
+    read_payload(reader);
+
+    if (!reader)
+        return false;
+
+    const auto payload_used = reader.used_bits() - payload_begin;
+    if (payload_used > header.bits)
+    {
+        reader.set_fail();
+        return false;
+    }
+
+    return reader.skip(header.bits - payload_used).operator bool();
+}
+
+} // namespace ibn
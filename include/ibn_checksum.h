@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <bn_span.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ibn
+{
+
+/// @brief Checksum algorithms, whose values are stored in the save headers.
+/// @note Don't change the values, or the existing saves can't be validated.
+enum class checksum_kind : std::uint8_t
+{
+    CRC32 = 0,      // zlib's crc32, which detects all the burst errors up to 32 bits.
+    FLETCHER32 = 1, // Fletcher-32 on 16-bit little-endian words, which is much cheaper but weaker.
+    ADLER32 = 2,    // zlib's Adler-32, which is as cheap as Fletcher-32, but weak on short data.
+    XXHASH32 = 3,   // xxHash32 (seed 0), which is not a CRC, but mixes well.
+
+    COUNT
+};
+
+/// @brief Checksum calculated chunk by chunk, with the algorithm chosen at run-time.
+///
+/// Feeding the data chunk by chunk is the same as feeding it all at once, regardless of the chunk boundaries.
+class checksum_stream final
+{
+public:
+    /// @brief Constructor.
+    /// @param kind Checksum algorithm.
+    explicit checksum_stream(checksum_kind kind);
+
+    /// @brief Continues the crc32 checksum of the preceding data.
+    /// @param previous_crc32 crc32 checksum of the preceding data.
+    static auto crc32(std::uint32_t previous_crc32) -> checksum_stream;
+
+public:
+    /// @brief Feeds the next chunk.
+    auto update(const void* data, std::size_t length) -> checksum_stream&;
+
+    /// @brief Feeds the next chunk.
+    template <typename Type>
+    auto update(bn::span<Type> items) -> checksum_stream&
+    {
+        return update(items.data(), items.size_bytes());
+    }
+
+    /// @brief Gets the checksum of all the chunks fed so far.
+    auto value() const -> std::uint32_t;
+
+    /// @brief Gets the checksum algorithm.
+    auto kind() const -> checksum_kind
+    {
+        return _kind;
+    }
+
+private:
+    void update_fletcher32(const std::uint8_t* bytes, std::size_t length);
+    void update_adler32(const std::uint8_t* bytes, std::size_t length);
+    void update_xxhash32(const std::uint8_t* bytes, std::size_t length);
+
+private:
+    checksum_kind _kind;
+
+    // Bytes not processed yet (Fletcher-32 odd byte, or xxHash32 partial stripe)
+    std::uint8_t _pending_size = 0;
+    std::uint8_t _pending[16];
+
+    // crc32 in `[0]`, Fletcher-32 & Adler-32 sums in `[0]` & `[1]`, or xxHash32 accumulators
+    std::uint32_t _state[4];
+
+    // Total length fed, which xxHash32 needs
+    std::uint32_t _length = 0;
+};
+
+} // namespace ibn
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <bn_common.h>
+
+/// @def IBN_CODE_IWRAM_ARM
+///
+/// Places the function in IWRAM, and generates ARM code for it. \n
+/// ARM code runs faster than Thumb code on IWRAM's 32-bit bus, and it's not slowed down by the ROM wait-states.
+///
+/// Put it on the function declaration, so that the callers know they need a long call to reach it.
+#if defined(__arm__)
+#define IBN_CODE_IWRAM_ARM BN_CODE_IWRAM __attribute__((target("arm")))
+#else
+#define IBN_CODE_IWRAM_ARM BN_CODE_IWRAM
+#endif
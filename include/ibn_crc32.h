@@ -8,12 +8,12 @@
 // see http://create.stephan-brumme.com/disclaimer.html
 //
 
-// if running on an embedded system, you might consider shrinking the
-// big Crc32Lookup table by undefining these lines:
-#define CRC32_USE_LOOKUP_TABLE_BYTE
-#define CRC32_USE_LOOKUP_TABLE_SLICING_BY_4
-// #define CRC32_USE_LOOKUP_TABLE_SLICING_BY_8   // (Edit) Commented out
-// #define CRC32_USE_LOOKUP_TABLE_SLICING_BY_16  // (Edit) Commented out
+// (Edit) the Crc32Lookup table is generated at compile time with IBN_CFG_CRC32_SLICES slices (1 KB each),
+// which defines these lines:
+//   CRC32_USE_LOOKUP_TABLE_BYTE          (1 or more)
+//   CRC32_USE_LOOKUP_TABLE_SLICING_BY_4  (4 or more)
+//   CRC32_USE_LOOKUP_TABLE_SLICING_BY_8  (8 or more)
+//   CRC32_USE_LOOKUP_TABLE_SLICING_BY_16 (16)
 // - crc32_bitwise  doesn't need it at all
 // - crc32_halfbyte has its own small lookup table
 // - crc32_1byte_tableless and crc32_1byte_tableless2 don't need it at all
@@ -29,6 +29,62 @@
 // size_t
 #include <cstddef>
 
+// (Edit) Option to place the table-driven kernels in IWRAM with ARM codegen
+#include "ibn_code_iwram.h"
+
+#ifndef IBN_CFG_CRC32_IWRAM
+#define IBN_CFG_CRC32_IWRAM false
+#endif
+
+#if IBN_CFG_CRC32_IWRAM
+#define IBN_CRC32_CODE IBN_CODE_IWRAM_ARM
+#else
+#define IBN_CRC32_CODE
+#endif
+
+// (Edit) Number of the Crc32Lookup slices: 0, 1, 4, 8 or 16
+#ifndef IBN_CFG_CRC32_SLICES
+#define IBN_CFG_CRC32_SLICES 4
+#endif
+
+#if IBN_CFG_CRC32_SLICES != 0 && IBN_CFG_CRC32_SLICES != 1 && IBN_CFG_CRC32_SLICES != 4 && \
+    IBN_CFG_CRC32_SLICES != 8 && IBN_CFG_CRC32_SLICES != 16
+#error "IBN_CFG_CRC32_SLICES must be 0, 1, 4, 8 or 16"
+#endif
+
+#if IBN_CFG_CRC32_SLICES >= 1
+#define CRC32_USE_LOOKUP_TABLE_BYTE
+#endif
+#if IBN_CFG_CRC32_SLICES >= 4
+#define CRC32_USE_LOOKUP_TABLE_SLICING_BY_4
+#endif
+#if IBN_CFG_CRC32_SLICES >= 8
+#define CRC32_USE_LOOKUP_TABLE_SLICING_BY_8
+#endif
+#if IBN_CFG_CRC32_SLICES >= 16
+#define CRC32_USE_LOOKUP_TABLE_SLICING_BY_16
+#endif
+
+// (Edit) Where to place the Crc32Lookup table
+// ROM costs no RAM, but its lookups are slowed down by the ROM wait-states.
+#define IBN_CRC32_TABLE_ROM 0
+#define IBN_CRC32_TABLE_EWRAM 1
+#define IBN_CRC32_TABLE_IWRAM 2
+
+#ifndef IBN_CFG_CRC32_TABLE
+#define IBN_CFG_CRC32_TABLE IBN_CRC32_TABLE_ROM
+#endif
+
+// (Edit) Host builds use the CPU's CRC instructions if available (PCLMULQDQ on x86-64, CRC32 on AArch64)
+#ifndef IBN_CFG_CRC32_HARDWARE
+#define IBN_CFG_CRC32_HARDWARE true
+#endif
+
+#if IBN_CFG_CRC32_HARDWARE && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__aarch64__)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define IBN_CRC32_HARDWARE
+#endif
+
 namespace ibn // (Edit) Add namespace
 {
 
@@ -39,6 +95,67 @@ uint32_t crc32_fast(const void* data, size_t length, uint32_t previousCrc32 = 0)
 /// merge two CRC32 such that result = crc32(dataB, lengthB, crc32(dataA, lengthA))
 uint32_t crc32_combine(uint32_t crcA, uint32_t crcB, size_t lengthB);
 
+/// (Edit) crc32_combine for a fixed lengthB, whose operator is precomputed (at compile time, if constexpr)
+/// combining is then a single 32x32 GF(2) matrix-vector multiplication, instead of log2(lengthB) matrix squarings
+class crc32_combiner
+{
+public:
+    /// prepare the operator of appending lengthB zero bytes
+    constexpr explicit crc32_combiner(size_t lengthB = 0) : _matrix()
+    {
+        // start with the identity
+        for (int i = 0; i < 32; i++)
+            _matrix[i] = uint32_t(1) << i;
+
+        // operator for one zero bit (zlib's CRC32 polynomial)
+        uint32_t zeros[32] = {0xEDB88320};
+        for (int i = 1; i < 32; i++)
+            zeros[i] = uint32_t(1) << (i - 1);
+
+        // operator for one zero byte
+        for (int i = 0; i < 3; i++)
+            square(zeros);
+
+        // apply lengthB zero bytes
+        for (; lengthB > 0; lengthB >>= 1)
+        {
+            if (lengthB & 1)
+                for (int i = 0; i < 32; i++)
+                    _matrix[i] = times(zeros, _matrix[i]);
+
+            square(zeros);
+        }
+    }
+
+    /// same as crc32_combine(crcA, crcB, lengthB)
+    constexpr uint32_t combine(uint32_t crcA, uint32_t crcB) const
+    {
+        return times(_matrix, crcA) ^ crcB;
+    }
+
+private:
+    static constexpr uint32_t times(const uint32_t (&matrix)[32], uint32_t vec)
+    {
+        // branchless, as the bits of a crc32 are random
+        uint32_t result = 0;
+        for (int i = 0; i < 32; i++, vec >>= 1)
+            result ^= matrix[i] & (0 - (vec & 1));
+        return result;
+    }
+
+    static constexpr void square(uint32_t (&matrix)[32])
+    {
+        uint32_t result[32] = {};
+        for (int i = 0; i < 32; i++)
+            result[i] = times(matrix, matrix[i]);
+        for (int i = 0; i < 32; i++)
+            matrix[i] = result[i];
+    }
+
+private:
+    uint32_t _matrix[32];
+};
+
 /// compute CRC32 (bitwise algorithm)
 uint32_t crc32_bitwise(const void* data, size_t length, uint32_t previousCrc32 = 0);
 /// compute CRC32 (half-byte algoritm)
@@ -46,7 +163,7 @@ uint32_t crc32_halfbyte(const void* data, size_t length, uint32_t previousCrc32
 
 #ifdef CRC32_USE_LOOKUP_TABLE_BYTE
 /// compute CRC32 (standard algorithm)
-uint32_t crc32_1byte(const void* data, size_t length, uint32_t previousCrc32 = 0);
+IBN_CRC32_CODE uint32_t crc32_1byte(const void* data, size_t length, uint32_t previousCrc32 = 0);
 #endif
 
 /// compute CRC32 (byte algorithm) without lookup tables
@@ -56,22 +173,33 @@ uint32_t crc32_1byte_tableless2(const void* data, size_t length, uint32_t previo
 
 #ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_4
 /// compute CRC32 (Slicing-by-4 algorithm)
-uint32_t crc32_4bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
+IBN_CRC32_CODE uint32_t crc32_4bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
+/// (Edit) compute CRC32 (Slicing-by-4 algorithm), unroll inner loop 4 times for the ARM7TDMI
+/// always ARM code in IWRAM (regardless of IBN_CFG_CRC32_IWRAM), opt-in as crc32_fast still uses crc32_4bytes
+IBN_CODE_IWRAM_ARM uint32_t crc32_4x4bytes_arm(const void* data, size_t length, uint32_t previousCrc32 = 0);
 #endif
 
 #ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_8
 /// compute CRC32 (Slicing-by-8 algorithm)
-uint32_t crc32_8bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
+IBN_CRC32_CODE uint32_t crc32_8bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
 /// compute CRC32 (Slicing-by-8 algorithm), unroll inner loop 4 times
-uint32_t crc32_4x8bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
+IBN_CRC32_CODE uint32_t crc32_4x8bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
 #endif
 
 #ifdef CRC32_USE_LOOKUP_TABLE_SLICING_BY_16
 /// compute CRC32 (Slicing-by-16 algorithm)
-uint32_t crc32_16bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
+IBN_CRC32_CODE uint32_t crc32_16bytes(const void* data, size_t length, uint32_t previousCrc32 = 0);
 /// compute CRC32 (Slicing-by-16 algorithm, prefetch upcoming data blocks)
-uint32_t crc32_16bytes_prefetch(const void* data, size_t length, uint32_t previousCrc32 = 0,
-                                size_t prefetchAhead = 256);
+IBN_CRC32_CODE uint32_t crc32_16bytes_prefetch(const void* data, size_t length, uint32_t previousCrc32 = 0,
+                                               size_t prefetchAhead = 256);
+#endif
+
+#ifdef IBN_CRC32_HARDWARE
+/// (Edit) check whether the host CPU supports crc32_hardware (detected once at run-time)
+bool crc32_hardware_supported();
+/// (Edit) compute CRC32 with the host CPU instructions (PCLMULQDQ folding on x86-64, CRC32 on AArch64)
+/// only if crc32_hardware_supported(), which is what crc32_fast uses on the host
+uint32_t crc32_hardware(const void* data, size_t length, uint32_t previousCrc32 = 0);
 #endif
 
 } // namespace ibn
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_crc32.h"
+
+#include <bn_assert.h>
+#include <bn_span.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace ibn
+{
+
+/// @brief crc32 checksum of a data, which is kept as a tree of the crc32 checksums of its fixed-size blocks.
+///
+/// Each parent node is the crc32 checksum of its children concatenated, which is combined with `crc32_combiner`. \n
+/// So, when a block changes, only its crc32 checksum and the combines up to the root are calculated again,
+/// instead of the crc32 checksum of the whole data.
+///
+/// The combine operators are prepared on `reset()`, so that each combine is a single matrix-vector multiplication.
+/// @tparam MaxBlocks Maximum number of blocks.
+template <int MaxBlocks>
+class crc32_block_tree final
+{
+    static_assert(MaxBlocks > 0, "Invalid MaxBlocks");
+
+private:
+    static constexpr int LEAVES = int(std::bit_ceil(unsigned(MaxBlocks)));
+
+    // Number of levels that have children, which are leaves at level `0`
+    static constexpr int LEVELS = std::max(1, std::countr_zero(unsigned(LEAVES)));
+
+public:
+    /// @brief Constructor.
+    /// @param block_size Size of each block in bytes.
+    explicit crc32_block_tree(unsigned block_size) : _block_size(block_size)
+    {
+        BN_ASSERT(block_size > 0, "Invalid block_size: ", block_size);
+
+        // Full right children at level `n` are `block_size << n` bytes
+        crc32_combiner combiner(block_size);
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            _full_combiners[level] = combiner;
+            if (level + 1 < LEVELS)
+                combiner = crc32_combiner(std::size_t(block_size) << (level + 1));
+        }
+    }
+
+public:
+    /// @brief Calculates the crc32 checksums of all the blocks of the data, and combines them.
+    /// @param data Data to calculate the crc32 checksum of, which must be `block_size() * MaxBlocks` bytes or less.
+    void reset(bn::span<const std::uint8_t> data)
+    {
+        const unsigned data_size = data.size();
+        const int blocks_count = int((data_size + _block_size - 1) / _block_size);
+        BN_ASSERT(blocks_count <= MaxBlocks, "Data too big: ", data_size);
+
+        _data_size = data_size;
+        _blocks_count = blocks_count;
+
+        // Only the parents of the last block can have a partial right child
+        for (int level = 0; level < LEVELS; ++level)
+        {
+            const unsigned right_size = right_child_size(leaf_node(blocks_count - 1) >> (level + 1), level);
+            if (right_size != 0 && right_size != (_block_size << level))
+                _partial_combiners[level] = crc32_combiner(right_size);
+        }
+
+        for (int index = 0; index < LEAVES; ++index)
+        {
+            const unsigned offset = std::min(index * _block_size, data_size);
+            const unsigned size = std::min(_block_size, data_size - offset);
+            _nodes[leaf_node(index)] = crc32_fast(data.data() + offset, size);
+        }
+
+        for (int node = LEAVES - 1; node >= 1; --node)
+            combine(node);
+    }
+
+    /// @brief Updates the crc32 checksum of the block, and combines it up to the root.
+    /// @param index Index of the block.
+    /// @param block New bytes of the block, which must be `block_size()` bytes except for the last block.
+    void update_block(int index, bn::span<const std::uint8_t> block)
+    {
+        BN_ASSERT(index >= 0 && index < _blocks_count, "Invalid block index: ", index);
+        BN_ASSERT(unsigned(block.size()) == std::min(_block_size, _data_size - index * _block_size),
+                  "Invalid block size: ", block.size());
+
+        int node = leaf_node(index);
+        _nodes[node] = crc32_fast(block.data(), block.size());
+
+        for (node >>= 1; node >= 1; node >>= 1)
+            combine(node);
+    }
+
+    /// @brief Gets the crc32 checksum of the whole data.
+    auto crc32() const -> std::uint32_t
+    {
+        return _nodes[1];
+    }
+
+    /// @brief Gets the crc32 checksum of the block.
+    /// @param index Index of the block.
+    auto block_crc32(int index) const -> std::uint32_t
+    {
+        BN_ASSERT(index >= 0 && index < _blocks_count, "Invalid block index: ", index);
+
+        return _nodes[leaf_node(index)];
+    }
+
+    /// @brief Gets the size of each block in bytes.
+    auto block_size() const -> unsigned
+    {
+        return _block_size;
+    }
+
+    /// @brief Gets the number of blocks of the data.
+    auto blocks_count() const -> int
+    {
+        return _blocks_count;
+    }
+
+    /// @brief Gets the size of the data in bytes.
+    auto data_size() const -> unsigned
+    {
+        return _data_size;
+    }
+
+private:
+    static constexpr auto leaf_node(int index) -> int
+    {
+        return LEAVES + index;
+    }
+
+    // Size in bytes of the right child of the node, whose children are at `level`
+    auto right_child_size(int node, int level) const -> unsigned
+    {
+        const unsigned first_leaf = unsigned(node * 2 + 1) << level;
+        const unsigned begin = std::min((first_leaf - LEAVES) * _block_size, _data_size);
+        const unsigned end = std::min(begin + (_block_size << level), _data_size);
+        return end - begin;
+    }
+
+    void combine(int node)
+    {
+        // Level of the children, which is `0` for leaves
+        const int level = std::countl_zero(unsigned(node)) - std::countl_zero(unsigned(LEAVES)) - 1;
+        const unsigned right_size = right_child_size(node, level);
+
+        const std::uint32_t left = _nodes[node * 2];
+        const std::uint32_t right = _nodes[node * 2 + 1];
+
+        if (right_size == 0)
+            _nodes[node] = left;
+        else if (right_size == (_block_size << level))
+            _nodes[node] = _full_combiners[level].combine(left, right);
+        else
+            _nodes[node] = _partial_combiners[level].combine(left, right);
+    }
+
+private:
+    const unsigned _block_size;
+    unsigned _data_size = 0;
+    int _blocks_count = 0;
+
+    // 1-based binary tree, whose leaves are the blocks
+    std::uint32_t _nodes[LEAVES * 2] = {};
+
+    crc32_combiner _full_combiners[LEVELS];
+    crc32_combiner _partial_combiners[LEVELS];
+};
+
+} // namespace ibn
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <concepts>
+#include <limits>
+
+namespace ibn
+{
+
+/// @brief Compares the sequence numbers that wrap around.
+/// @return Whether @p a is ahead of @p b by less than half the range or not.
+template <std::unsigned_integral UInt>
+constexpr bool sequence_greater_than(UInt a, UInt b)
+{
+    return ((a > b) && (a - b <= std::numeric_limits<UInt>::max() / 2)) ||
+           ((a < b) && (b - a > std::numeric_limits<UInt>::max() / 2));
+}
+
+} // namespace ibn
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "ibn_code_iwram.h"
 #include "ibn_function.h"
 
 #include <bn_fixed_point.h>
@@ -31,6 +32,17 @@
 #define IBN_CFG_SPRITE_TEXT_TYPEWRITER_DELEGATES_MAX_SIZE 11
 #endif
 
+#ifndef IBN_CFG_SPRITE_TEXT_TYPEWRITER_IWRAM
+#define IBN_CFG_SPRITE_TEXT_TYPEWRITER_IWRAM false
+#endif
+
+#if IBN_CFG_SPRITE_TEXT_TYPEWRITER_IWRAM
+// Placement of the typing state update.
+#define IBN_SPRITE_TEXT_TYPEWRITER_CODE IBN_CODE_IWRAM_ARM
+#else
+#define IBN_SPRITE_TEXT_TYPEWRITER_CODE
+#endif
+
 namespace bn
 {
 
@@ -173,7 +185,7 @@ private:
     class type_state final : public state
     {
     public:
-        void update(sprite_text_typewriter&) override;
+        IBN_SPRITE_TEXT_TYPEWRITER_CODE void update(sprite_text_typewriter&) override;
 
     private:
         void flag_new_sprite_required(sprite_text_typewriter&);
@@ -0,0 +1,248 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_bit_stream.h"
+#include "ibn_bit_stream_section.h"
+#include "ibn_ceil_to_multiple_of.h"
+#include "ibn_crc32.h"
+#include "ibn_sram_rw.h"
+#include "ibn_storage.h"
+
+#include <bn_assert.h>
+#include <bn_span.h>
+#include <bn_string_view.h>
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#ifndef IBN_CFG_SRAM_JOURNAL_MAX_RECORD_SIZE
+#define IBN_CFG_SRAM_JOURNAL_MAX_RECORD_SIZE 64
+#endif
+
+namespace ibn
+{
+
+/// @brief Save data that can be saved as a snapshot, and updated by replaying the journal records.
+/// @note `apply()` reads a single record written by `sram_journal::append()`, and must consume all of it. \n
+/// If it fails the reader or leaves bytes unread, the record is treated as malformed.
+template <typename T>
+concept sram_journal_save_data = sram_save_data<T> && requires(T save_data, bit_stream_reader& reader) {
+    { save_data.apply(reader) } -> std::same_as<void>;
+};
+
+/// @brief Log-structured save store, which appends small delta records instead of rewriting the whole save data.
+///
+/// The save data is stored as a snapshot with `sram_rw` (so, in two alternating locations),
+/// and the delta records since the snapshot are appended to a separate journal region. \n
+/// On load, the snapshot is read, and then the records are replayed on top of it. \n
+/// When the journal region gets full, `compact()` writes a fresh snapshot, which discards all the records.
+///
+/// Each record is protected with its own crc32 checksum, so a record torn by a power loss ends the journal there. \n
+/// Also, each record is tagged with the generation of the snapshot it applies to,
+/// so that the records of the previous snapshots are ignored without erasing the journal region. \n
+/// (If the storage needs erasing, the journal region is erased on `compact()` instead, as records can't overwrite.)
+class sram_journal final
+{
+private:
+    static constexpr unsigned MAX_RECORD_SIZE = IBN_CFG_SRAM_JOURNAL_MAX_RECORD_SIZE;
+
+    struct record_header final
+    {
+        // checksum includes not only payload, but also headers below
+        std::uint32_t crc32;
+        std::uint16_t generation;
+        std::uint16_t payload_size;
+    };
+
+    static constexpr unsigned HEADER_WORDS = sizeof(record_header) / sizeof(bit_stream_writer::word_type);
+    static constexpr unsigned PAYLOAD_WORDS =
+        ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(MAX_RECORD_SIZE) /
+        sizeof(bit_stream_writer::word_type);
+    static constexpr unsigned RECORD_BUFFER_WORDS = HEADER_WORDS + PAYLOAD_WORDS;
+
+    static_assert(sizeof(record_header) % sizeof(bit_stream_writer::word_type) == 0,
+                  "Record header makes payload not aligned to bit stream words");
+
+    // Prepends the snapshot generation to the save data.
+    template <typename SaveData>
+    struct snapshot final
+    {
+        // Forwarded, so that a snapshot of another schema is rejected
+        static constexpr std::uint32_t SCHEMA_HASH = sram_schema_hash_of<std::remove_const_t<SaveData>>();
+
+        SaveData* save_data;
+        std::uint16_t generation;
+
+        void measure(bit_stream_measurer& measurer) const
+        {
+            measurer.write(generation);
+            save_data->measure(measurer);
+        }
+
+        void write(bit_stream_writer& writer) const
+        {
+            writer.write(generation);
+            save_data->write(writer);
+        }
+
+        void read(bit_stream_reader& reader)
+        {
+            reader.read(generation);
+            save_data->read(reader);
+        }
+    };
+
+public:
+    /// @brief Constructor.
+    /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
+    /// @param snapshot_location_0 First SRAM location to store the snapshot.
+    /// @param snapshot_location_1 Second SRAM location to store the snapshot.
+    /// @param journal_location SRAM location of the journal region.
+    /// @param journal_size Size of the journal region in bytes.
+    /// @param storage_ Storage to store the snapshots and the journal, which must outlive this. \n
+    /// If it needs erasing, all the locations and the journal size must be aligned to its erase block size.
+    sram_journal(bn::string_view magic, unsigned snapshot_location_0, unsigned snapshot_location_1,
+                 unsigned journal_location, unsigned journal_size, storage& storage_ = sram_storage::instance());
+
+public:
+    /// @brief Loads the snapshot, and replays the journal records on top of it.
+    /// @tparam SaveData Save data class that satisfies `sram_journal_save_data` concept.
+    /// @param save_data Save data to be loaded.
+    /// @return Whether the snapshot and all its valid records have been loaded or not. \n
+    /// If not, you should `compact()` an initial save data before appending any record. \n
+    /// A record that passes its checksum but is malformed for `apply()` fails the load,
+    /// and leaves @p save_data updated up to that record.
+    template <sram_journal_save_data SaveData>
+    bool load(SaveData& save_data)
+    {
+        _has_snapshot = false;
+        _journal_used = 0;
+
+        snapshot<SaveData> snap{&save_data, 0};
+        if (!_snapshot_rw.read(snap))
+            return false;
+
+        _generation = snap.generation;
+
+        // Replay the records until the first invalid one
+        bit_stream_writer::word_type buffer[RECORD_BUFFER_WORDS];
+        bit_stream_reader::size_type payload_size;
+        while (read_record(buffer, payload_size))
+        {
+            bit_stream_reader reader(buffer + HEADER_WORDS, PAYLOAD_WORDS, payload_size);
+            save_data.apply(reader);
+
+            if (reader.fail() || reader.unused_bytes() != 0)
+                return false;
+
+            _journal_used += record_size(payload_size);
+        }
+
+        // Torn record can't be overwritten without erasing, so leave no room until the next `compact()`
+        if (!tail_writable())
+            _journal_used = _journal_size;
+
+        _has_snapshot = true;
+        return true;
+    }
+
+    /// @brief Appends a delta record to the journal.
+    /// @note This writes only `8 + record size` bytes to the SRAM.
+    /// @tparam Record Record class that satisfies `bit_stream_section_data` concept.
+    /// @param record Record to be appended, which must be `IBN_CFG_SRAM_JOURNAL_MAX_RECORD_SIZE` bytes or less.
+    /// @return Whether the record has been appended or not. \n
+    /// If the journal region is full, this returns `false`, and you should `compact()` the up-to-date save data.
+    template <bit_stream_section_data Record>
+    bool append(const Record& record)
+    {
+        BN_ASSERT(_has_snapshot, "No snapshot to append the record to");
+
+        // Measure how much space required
+        bit_stream_measurer measurer;
+        record.measure(measurer);
+
+        const unsigned payload_size = measurer.used_bytes();
+        BN_ASSERT(payload_size <= MAX_RECORD_SIZE, "Record size too big: ", payload_size);
+
+        if (_journal_used + record_size(payload_size) > _journal_size)
+            return false;
+
+        // Serialize the record after the header
+        bit_stream_writer::word_type buffer[RECORD_BUFFER_WORDS];
+        bit_stream_writer writer(buffer + HEADER_WORDS, PAYLOAD_WORDS, payload_size);
+        record.write(writer);
+        writer.flush_final();
+
+        // User must have correctly serialized their record to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing record");
+
+        write_record(buffer, payload_size);
+        return true;
+    }
+
+    /// @brief Writes a fresh snapshot of the save data, which discards all the journal records.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Up-to-date save data, with all the appended records applied.
+    template <sram_save_data SaveData>
+    void compact(const SaveData& save_data)
+    {
+        // Without a loaded snapshot, skip past the generation of the stale records
+        const std::uint16_t next_generation =
+            std::uint16_t((_has_snapshot ? _generation : journal_head_generation()) + 1);
+
+        const snapshot<const SaveData> snap{&save_data, next_generation};
+        _snapshot_rw.write_streamed(snap);
+        erase_journal();
+
+        _generation = next_generation;
+        _has_snapshot = true;
+        _journal_used = 0;
+    }
+
+public:
+    /// @brief Gets the number of bytes used by the records in the journal region.
+    auto journal_used_bytes() const -> unsigned
+    {
+        return _journal_used;
+    }
+
+    /// @brief Gets the size of the journal region in bytes.
+    auto journal_size() const -> unsigned
+    {
+        return _journal_size;
+    }
+
+private:
+    static auto record_size(unsigned payload_size) -> unsigned;
+
+    // Generation of the record at the beginning of the journal, which is the most recent one that appended a record
+    auto journal_head_generation() const -> std::uint16_t;
+
+    // Reads the next record (header + payload) from the journal to the `buffer`, and validates it
+    bool read_record(bit_stream_writer::word_type* buffer, bit_stream_reader::size_type& payload_size) const;
+
+    // Writes the record header to the `buffer`, and writes the whole record to the journal
+    void write_record(bit_stream_writer::word_type* buffer, unsigned payload_size);
+
+    // Erases the journal region, if the storage needs erasing before writing the records
+    void erase_journal();
+
+    // Checks if the next record can be written after the valid records, without erasing
+    bool tail_writable() const;
+
+private:
+    storage* _storage;
+    sram_rw _snapshot_rw;
+
+    const unsigned _journal_location;
+    const unsigned _journal_size;
+    unsigned _journal_used = 0;
+
+    std::uint16_t _generation = 0;
+    bool _has_snapshot = false;
+};
+
+} // namespace ibn
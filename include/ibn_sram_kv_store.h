@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_bit_stream.h"
+#include "ibn_bit_stream_section.h"
+#include "ibn_ceil_to_multiple_of.h"
+#include "ibn_storage.h"
+
+#include <bn_assert.h>
+#include <bn_span.h>
+#include <bn_string_view.h>
+
+#include <concepts>
+#include <cstdint>
+
+#ifndef IBN_CFG_SRAM_KV_STORE_MAX_KEYS
+#define IBN_CFG_SRAM_KV_STORE_MAX_KEYS 32
+#endif
+
+#ifndef IBN_CFG_SRAM_KV_STORE_MAX_VALUE_SIZE
+#define IBN_CFG_SRAM_KV_STORE_MAX_VALUE_SIZE 64
+#endif
+
+namespace ibn
+{
+
+/// @brief Key-value store on the SRAM, for many small values updated independently. (e.g. options, unlock flags)
+///
+/// Keys are the indexes of the `max_value_sizes` passed to the constructor,
+/// and each key gets its own two alternating slots of its max value size. \n
+/// So, rewriting a key only writes that key's value, and a power loss in the middle keeps its previous value.
+///
+/// Values are encoded with the bit streams, and each of them is protected with its own crc32 checksum. \n
+/// The in-RAM index is built once on construction, which makes the lookups O(1) without touching the SRAM.
+///
+/// Erasing a key writes an empty tombstone to its other slot, so a power loss in the middle keeps the value too. \n
+/// As the slots are rewritten in place, there's nothing to compact, and the store never grows.
+class sram_kv_store final
+{
+public:
+    using key_type = std::uint8_t;
+
+private:
+    static constexpr unsigned MAGIC_LEN = 5;
+    static constexpr unsigned MAX_KEYS = IBN_CFG_SRAM_KV_STORE_MAX_KEYS;
+    static constexpr unsigned MAX_VALUE_SIZE = IBN_CFG_SRAM_KV_STORE_MAX_VALUE_SIZE;
+
+    struct slot_header final
+    {
+        // checksum includes not only value, but also headers below (and the magic)
+        std::uint32_t crc32;
+        key_type key;
+        std::uint8_t sequence;
+        std::uint16_t value_size; // `TOMBSTONE` if erased
+    };
+
+    static constexpr std::uint16_t TOMBSTONE = 0xFFFF;
+
+    static constexpr unsigned HEADER_WORDS = sizeof(slot_header) / sizeof(bit_stream_writer::word_type);
+    static constexpr unsigned VALUE_WORDS =
+        ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(MAX_VALUE_SIZE) /
+        sizeof(bit_stream_writer::word_type);
+    static constexpr unsigned SLOT_BUFFER_WORDS = HEADER_WORDS + VALUE_WORDS;
+
+    static_assert(sizeof(slot_header) % sizeof(bit_stream_writer::word_type) == 0,
+                  "Slot header makes value not aligned to bit stream words");
+    static_assert(MAX_KEYS <= 256, "Key type can't represent all keys");
+    static_assert(MAX_VALUE_SIZE < TOMBSTONE, "IBN_CFG_SRAM_KV_STORE_MAX_VALUE_SIZE too big");
+
+    struct entry final
+    {
+        std::uint16_t location;
+        std::uint16_t max_value_size;
+        std::uint16_t value_size;
+        std::uint8_t sequence;
+        std::int8_t current_slot; // `-1` if never written
+        bool erased;
+    };
+
+public:
+    /// @brief Constructor, which builds the index from the SRAM.
+    /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
+    /// @param location SRAM location of the store.
+    /// @param max_value_sizes Max value size in bytes of each key, indexed by key.
+    /// @param storage_ Storage to store the values, which must outlive this. \n
+    /// As the slots are rewritten in place, it must not need erasing. (e.g. SRAM)
+    sram_kv_store(bn::string_view magic, unsigned location, bn::span<const std::uint16_t> max_value_sizes,
+                  storage& storage_ = sram_storage::instance());
+
+public:
+    /// @brief Gets the number of SRAM bytes the store occupies.
+    auto size_bytes() const -> unsigned
+    {
+        return _size_bytes;
+    }
+
+    /// @brief Indicates if the key has a value or not.
+    bool contains(key_type key) const
+    {
+        BN_ASSERT(key < _keys_count, "Invalid key: ", key);
+
+        return _entries[key].current_slot >= 0 && !_entries[key].erased;
+    }
+
+    /// @brief Erases the value of the key, without rewriting the other keys.
+    /// @note If the key has no value, this writes nothing.
+    void erase(key_type key);
+
+    /// @brief Writes the value of the key, without rewriting the other keys.
+    /// @tparam Value Value class that satisfies `bit_stream_section_data` concept.
+    /// @param key Key to write the value.
+    /// @param value Value to write, which must fit in the max value size of the key.
+    template <bit_stream_section_data Value>
+    void write(key_type key, const Value& value)
+    {
+        BN_ASSERT(key < _keys_count, "Invalid key: ", key);
+
+        // Measure how much space required
+        bit_stream_measurer measurer;
+        value.measure(measurer);
+
+        const unsigned value_size = measurer.used_bytes();
+        BN_ASSERT(value_size <= _entries[key].max_value_size, "Value size too big: ", value_size, " (key ", key, ")");
+
+        // Serialize the value after the header
+        bit_stream_writer::word_type buffer[SLOT_BUFFER_WORDS];
+        bit_stream_writer writer(buffer + HEADER_WORDS, VALUE_WORDS, value_size);
+        value.write(writer);
+        writer.flush_final();
+
+        // User must have correctly serialized their value to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing value");
+
+        write_slot(key, buffer, value_size);
+    }
+
+    /// @brief Reads the value of the key with @p read_value.
+    /// @param key Key to read the value.
+    /// @param read_value Callable that reads the value, invoked with a reader on the value.
+    /// @return Whether the value has been read or not.
+    template <typename ReadValue>
+        requires std::invocable<ReadValue&, bit_stream_reader&>
+    bool read(key_type key, ReadValue&& read_value) const
+    {
+        bit_stream_reader::word_type buffer[VALUE_WORDS];
+        if (!read_slot(key, buffer))
+            return false;
+
+        bit_stream_reader reader(buffer, VALUE_WORDS, _entries[key].value_size);
+        read_value(reader);
+        return !reader.fail();
+    }
+
+    /// @brief Writes a single value (e.g. integer, enum, `bn::fixed`) of the key.
+    /// @param key Key to write the value.
+    /// @param value Value to write.
+    template <typename T>
+    void write_value(key_type key, const T& value)
+    {
+        write(key, single_value<T>{&value});
+    }
+
+    /// @brief Reads a single value (e.g. integer, enum, `bn::fixed`) of the key.
+    /// @param key Key to read the value.
+    /// @param value Value to read to, which is left untouched if not read.
+    /// @return Whether the value has been read or not.
+    template <typename T>
+    bool read_value(key_type key, T& value) const
+    {
+        T result;
+        if (!read(key, [&result](bit_stream_reader& reader) { reader.read(result); }))
+            return false;
+
+        value = result;
+        return true;
+    }
+
+private:
+    template <typename T>
+    struct single_value final
+    {
+        const T* value;
+
+        void measure(bit_stream_measurer& measurer) const
+        {
+            measurer.write(*value);
+        }
+
+        void write(bit_stream_writer& writer) const
+        {
+            writer.write(*value);
+        }
+    };
+
+private:
+    static auto slot_size(unsigned max_value_size) -> unsigned;
+
+    void build_index();
+
+    // Reads & validates the slot (header + value) to the `buffer`
+    bool load_slot(key_type key, int slot, bit_stream_writer::word_type* buffer, slot_header& header) const;
+
+    bool read_slot(key_type key, bit_stream_reader::word_type* value_buffer) const;
+
+    // Writes the slot to the other location of the key, where `value_size` is `TOMBSTONE` to erase
+    void write_slot(key_type key, bit_stream_writer::word_type* buffer, unsigned value_size);
+
+    auto slot_crc32(const bit_stream_writer::word_type* buffer, unsigned value_size) const -> std::uint32_t;
+
+private:
+    storage* _storage;
+    entry _entries[MAX_KEYS];
+    unsigned _keys_count;
+
+    const unsigned _location;
+    unsigned _size_bytes;
+
+    // crc32 checksum of the magic, which seeds the checksums of the slots
+    std::uint32_t _magic_crc32;
+};
+
+} // namespace ibn
@@ -5,7 +5,11 @@
 
 #include "ibn_bit_stream.h"
 #include "ibn_ceil_to_multiple_of.h"
+#include "ibn_checksum.h"
 #include "ibn_crc32.h"
+#include "ibn_sequence_greater_than.h"
+#include "ibn_stats.h"
+#include "ibn_storage.h"
 
 #include <alloca.h>
 
@@ -14,15 +18,26 @@
 #include <bn_math.h>
 #include <bn_optional.h>
 #include <bn_span.h>
-#include <bn_sram.h>
 #include <bn_string_view.h>
 
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 
+#ifndef IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE
+#define IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE 256
+#endif
+
+#ifndef IBN_CFG_SRAM_RW_INCREMENTAL_BLOCK_SIZE
+#define IBN_CFG_SRAM_RW_INCREMENTAL_BLOCK_SIZE 64
+#endif
+
 namespace ibn
 {
 
+/// @brief Save data that can be measured, written and read with the bit streams.
+/// @note Reading must consume exactly what has been written. \n
+/// To keep the old saves loadable as the schema evolves, frame the save data with `ibn_bit_stream_section.h`.
 template <typename T>
 concept sram_save_data =
     requires(T save_data, bit_stream_measurer& measurer, bit_stream_writer& writer, bit_stream_reader& reader) {
@@ -31,40 +46,228 @@ concept sram_save_data =
         { save_data.read(reader) } -> std::same_as<void>;
     };
 
+/// @brief Save data that declares the hash of its schema, as `static constexpr std::uint32_t SCHEMA_HASH`.
+///
+/// The schema hash is stored in the header, so a save of another schema is rejected right after reading the header,
+/// without checking its checksum or deserializing it. \n
+/// Change it whenever the layout of the save data changes, e.g. with `sram_schema_hash()` of the field descriptors.
+template <typename T>
+concept sram_save_data_with_schema_hash = sram_save_data<T> && requires {
+    { T::SCHEMA_HASH } -> std::convertible_to<std::uint32_t>;
+};
+
+/// @brief Calculates the schema hash (32-bit FNV-1a) of the descriptor, at compile time.
+/// @param descriptor Descriptor of the save data fields. (e.g. `"u32 id; u8 name[8]; u16 items[64]"`)
+constexpr auto sram_schema_hash(bn::string_view descriptor) -> std::uint32_t
+{
+    std::uint32_t hash = 2166136261u;
+    for (const char ch : descriptor)
+        hash = (hash ^ std::uint8_t(ch)) * 16777619u;
+
+    return hash;
+}
+
+/// @brief Gets the schema hash of the save data, which is `0` if it doesn't declare one.
+template <sram_save_data SaveData>
+constexpr auto sram_schema_hash_of() -> std::uint32_t
+{
+    if constexpr (sram_save_data_with_schema_hash<SaveData>)
+        return SaveData::SCHEMA_HASH;
+    else
+        return 0;
+}
+
 class sram_rw final
 {
 private:
-    static constexpr unsigned SRAM_SIZE = bn::sram::size();
-
     static constexpr unsigned MAGIC_LEN = 5;
     static constexpr unsigned DEFAULT_ALLOCA_SIZE = 256;
-
+    static constexpr unsigned DEFAULT_UPDATE_BYTES = 1024;
+    static constexpr unsigned STREAM_CHUNK_WORDS =
+        IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE / sizeof(bit_stream_writer::word_type);
+    static constexpr unsigned BLOCK_SIZE = IBN_CFG_SRAM_RW_INCREMENTAL_BLOCK_SIZE;
+    static constexpr unsigned BLOCK_WORDS = BLOCK_SIZE / sizeof(bit_stream_writer::word_type);
+
+    // Appends a block to the crc32 checksum from the block's own crc32, without calculating it again
+    static constexpr crc32_combiner BLOCK_COMBINER{BLOCK_SIZE};
+
+    // Header format version 1, which is written by this.
+    //
+    // Legacy headers (version 0) are only the first `LEGACY_HEADER_SIZE` bytes, followed by the data right away. \n
+    // They're still read as crc32 saves without schema hash, if the `version` bytes don't match `HEADER_VERSION`.
+    // (A legacy save of which data happens to start with them can't be read, but it's unlikely with 3 bytes.)
     struct header final
     {
         // checksum includes not only data, but also headers below
-        std::uint32_t crc32;
+        std::uint32_t checksum;
         std::uint8_t magic[MAGIC_LEN];
         std::uint8_t sequence;
         std::uint16_t data_size;
+        // Below are since version 1
+        std::uint32_t schema_hash;
+        std::uint8_t checksum_id; // `checksum_kind` of `checksum`
+        std::uint8_t version[3];  // `HEADER_VERSION`, which is all `0` for the legacy headers read
+    };
+
+    static constexpr std::uint8_t HEADER_VERSION[3] = {'i', 'b', 1};
+    static constexpr unsigned LEGACY_HEADER_SIZE = 12;
+
+    // What's known about a location, without reading it again
+    enum class location_state : std::uint8_t
+    {
+        UNKNOWN,
+        INVALID,
+        VALID, // checksum validated
     };
 
     static_assert(sizeof(header) % sizeof(bit_stream_writer::word_type) == 0,
                   "Header makes data portion not aligned to bit stream words");
+    static_assert(sizeof(header) == 20 && offsetof(header, schema_hash) == LEGACY_HEADER_SIZE,
+                  "Header format changed without a new version");
     static_assert(__BIGGEST_ALIGNMENT__ >= sizeof(bit_stream_writer::word_type),
                   "`alloca()` is not aligned to bit stream words");
+    static_assert(STREAM_CHUNK_WORDS > 0, "IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE too small");
+    static_assert(BLOCK_WORDS > 0 && BLOCK_SIZE % sizeof(bit_stream_writer::word_type) == 0,
+                  "IBN_CFG_SRAM_RW_INCREMENTAL_BLOCK_SIZE must be a multiple of bit stream words");
+
+    // Writes the flushed words to the storage, while updating the checksum.
+    class sram_sink final : public bit_stream_sink
+    {
+    public:
+        sram_sink(storage& storage_, int location, const checksum_stream& checksum);
+
+        void consume(bn::span<const bit_stream_writer::word_type> words) override;
+
+        auto checksum() const -> std::uint32_t
+        {
+            return _checksum.value();
+        }
+
+    private:
+        storage* _storage;
+        int _location;
+        checksum_stream _checksum;
+    };
+
+    // Reads the words of an already validated save from the storage.
+    class sram_source final : public bit_stream_source
+    {
+    public:
+        sram_source(storage& storage_, int location, unsigned words_count);
+
+        void fetch(bit_stream_reader::size_type first_word_index, bn::span<bit_stream_reader::word_type> words) override;
+
+    private:
+        storage* _storage;
+        int _location;
+        unsigned _words_count;
+    };
+
+    // Writes only the blocks whose crc32 checksum differs from the one previously written to the same location.
+    class incremental_sram_sink final : public bit_stream_sink
+    {
+    public:
+        incremental_sram_sink(storage& storage_, int location, const checksum_stream& checksum,
+                              std::uint32_t* block_crc32s, unsigned prev_blocks_count);
+
+        // `words` must be a single block, as the chunk buffer is a block.
+        void consume(bn::span<const bit_stream_writer::word_type> words) override;
+
+        auto checksum() const -> std::uint32_t
+        {
+            return _checksum.value();
+        }
+
+        auto blocks_count() const -> unsigned
+        {
+            return _blocks_count;
+        }
+
+        auto written_bytes() const -> unsigned
+        {
+            return _written_bytes;
+        }
+
+    private:
+        storage* _storage;
+        int _location;
+        checksum_stream _checksum;
+
+        std::uint32_t* _block_crc32s;
+        unsigned _prev_blocks_count;
+        unsigned _blocks_count = 0;
+
+        unsigned _written_bytes = 0;
+    };
 
 public:
     /// @brief Constructor.
     /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
     /// @param location_0 First SRAM location to store the save data.
     /// @param location_1 Second SRAM location to store the save data.
-    sram_rw(bn::span<const std::uint8_t> magic, unsigned location_0, unsigned location_1);
+    /// @param storage_ Storage to store the save data, which must outlive this. \n
+    /// If it needs erasing, both locations must be aligned to its erase block size.
+    /// @param checksum Checksum algorithm to write the save data with. \n
+    /// Saves are read with the algorithm recorded in their header, so it can be changed without losing the old saves.
+    sram_rw(bn::span<const std::uint8_t> magic, unsigned location_0, unsigned location_1,
+            storage& storage_ = sram_storage::instance(), checksum_kind checksum = checksum_kind::CRC32);
 
     /// @brief Constructor.
     /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
     /// @param location_0 First SRAM location to store the save data.
     /// @param location_1 Second SRAM location to store the save data.
-    sram_rw(bn::string_view magic, unsigned location_0, unsigned location_1);
+    /// @param storage_ Storage to store the save data, which must outlive this. \n
+    /// If it needs erasing, both locations must be aligned to its erase block size.
+    /// @param checksum Checksum algorithm to write the save data with. \n
+    /// Saves are read with the algorithm recorded in their header, so it can be changed without losing the old saves.
+    sram_rw(bn::string_view magic, unsigned location_0, unsigned location_1,
+            storage& storage_ = sram_storage::instance(), checksum_kind checksum = checksum_kind::CRC32);
+
+    /// @brief Destructor.
+    /// @note If a background write is still in progress, it's aborted, and the previous save is kept.
+    ~sram_rw();
+
+    sram_rw(const sram_rw&) = delete;
+    auto operator=(const sram_rw&) -> sram_rw& = delete;
+
+public:
+    /// @brief Gets the number of SRAM bytes a location occupies to store the save data.
+    /// @param data_size Size of the save data in bytes. (i.e. `bit_stream_measurer::used_bytes()`)
+    static constexpr auto occupied_bytes(unsigned data_size) -> unsigned
+    {
+        return sizeof(header) + ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(data_size);
+    }
+
+    /// @brief Validates both locations, and caches which of them have a valid save along with their headers.
+    ///
+    /// After this, `has_save()` and `read()` don't read the headers or calculate the checksums again,
+    /// and the writes keep the cache up to date. \n
+    /// This also continues the sequence of the recent valid save, like `resume_sequence()`.
+    /// @note The locations validated once are not validated again, so this assumes that
+    /// this `sram_rw` is the only one writing to its locations.
+    /// @return Whether there's a valid save or not.
+    bool scan();
+
+    /// @brief Continues the sequence of the recent valid save in the SRAM, without loading the save data.
+    ///
+    /// Call this instead of `read()` before writing, if you don't need to load the save data. \n
+    /// Otherwise, the first write might overwrite the recent save, instead of the older one.
+    /// @note This is the same as `scan()`.
+    /// @return Whether there's a valid save or not.
+    bool resume_sequence();
+
+    /// @brief Indicates if there's a valid save or not, which `scan()`s if not scanned yet.
+    bool has_save();
+
+    /// @brief Gets the size in bytes of the recent valid save data, which `scan()`s if not scanned yet.
+    /// @return Size of the recent valid save data, or `0` if there's no valid save.
+    auto saved_data_size() -> unsigned;
+
+    /// @brief Gets the schema hash of the recent valid save, which `scan()`s if not scanned yet.
+    ///
+    /// Use this to pick the `SaveData` type to read an old save with, and migrate it to the current one.
+    /// @return Schema hash of the recent valid save, or `0` if there's no valid save (or it has no schema hash).
+    auto saved_schema_hash() -> std::uint32_t;
 
 public:
 #pragma GCC diagnostic push
@@ -77,16 +280,19 @@ public:
     template <sram_save_data SaveData>
     void write(const SaveData& save_data, unsigned max_stack_buffer_size = DEFAULT_ALLOCA_SIZE)
     {
+        BN_ASSERT(done(), "Background write in progress");
+
         // Measure how much space required
+        IBN_STATS_SRAM_RW_BEGIN_SAVE;
         bit_stream_measurer measurer;
-        save_data.measure(measurer);
+        {
+            IBN_STATS_SRAM_RW_PHASE(MEASURE);
+            save_data.measure(measurer);
+        }
 
         const unsigned raw_data_size = measurer.used_bytes();
-        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
-        const unsigned buffer_size = sizeof(header) + ceiled_data_size;
-
-        BN_ASSERT(buffer_size <= SRAM_SIZE / 2, "Save data size too big: ", raw_data_size);
-        ensure_no_locations_overlap(buffer_size);
+        const unsigned buffer_size = occupied_bytes(raw_data_size);
+        BN_ASSERT(buffer_size <= unsigned(_storage->size()) / 2, "Save data size too big: ", raw_data_size);
 
         // `alloca()` on small sizes
         const bool use_stack_buffer = buffer_size <= max_stack_buffer_size;
@@ -98,36 +304,270 @@ public:
         else
             buffer = new std::uint8_t[buffer_size];
 
+        write_with_buffer(save_data, raw_data_size, buffer);
+
+        // Deallocate temporary buffer
+        if (!use_stack_buffer)
+            delete[] buffer;
+    }
+
+#pragma GCC diagnostic pop
+
+    /// @brief Writes the save data to the SRAM, using the caller-provided scratch buffer instead of allocating one.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be saved.
+    /// @param scratch Scratch buffer, which must be `required_scratch_bytes(save_data)` bytes or more.
+    template <sram_save_data SaveData>
+    void write(const SaveData& save_data, bn::span<bit_stream_writer::word_type> scratch)
+    {
+        BN_ASSERT(done(), "Background write in progress");
+
+        // Measure how much space required
+        IBN_STATS_SRAM_RW_BEGIN_SAVE;
+        bit_stream_measurer measurer;
+        {
+            IBN_STATS_SRAM_RW_PHASE(MEASURE);
+            save_data.measure(measurer);
+        }
+
+        const unsigned raw_data_size = measurer.used_bytes();
+        const unsigned buffer_size = occupied_bytes(raw_data_size);
+        BN_ASSERT(buffer_size <= unsigned(_storage->size()) / 2, "Save data size too big: ", raw_data_size);
+        BN_ASSERT(buffer_size <= unsigned(scratch.size_bytes()), "Scratch buffer too small: ", scratch.size_bytes(),
+                  " (must be ", buffer_size, ")");
+
+        write_with_buffer(save_data, raw_data_size, reinterpret_cast<std::uint8_t*>(scratch.data()));
+    }
+
+    /// @brief Gets the number of scratch buffer bytes required to write or read the save data with a scratch buffer.
+    ///
+    /// Reserve a scratch buffer of this size once (e.g. at boot), and pass it to `write()` and `read()`,
+    /// so that they never allocate. \n
+    /// If the save data size varies, pass the biggest possible save data, or use `occupied_bytes()` instead.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be written or read.
+    template <sram_save_data SaveData>
+    static auto required_scratch_bytes(const SaveData& save_data) -> unsigned
+    {
+        bit_stream_measurer measurer;
+        save_data.measure(measurer);
+
+        return occupied_bytes(measurer.used_bytes());
+    }
+
+    /// @brief Writes the save data to the SRAM, without serializing it to a temporary buffer first.
+    ///
+    /// The save data is serialized in small chunks (`IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE` bytes on the stack),
+    /// each of which is written to the SRAM right away, and the header is written last. \n
+    /// The saved format is the same as `write()`, so it can be read with `read()`.
+    /// @note `SaveData::write()` is called only once, so it must write exactly what `SaveData::measure()` measured.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be saved.
+    template <sram_save_data SaveData>
+    void write_streamed(const SaveData& save_data)
+    {
+        BN_ASSERT(done(), "Background write in progress");
+
+        // Measure how much space required
+        IBN_STATS_SRAM_RW_BEGIN_SAVE;
+        bit_stream_measurer measurer;
+        {
+            IBN_STATS_SRAM_RW_PHASE(MEASURE);
+            save_data.measure(measurer);
+        }
+
+        const unsigned raw_data_size = measurer.used_bytes();
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
+        const unsigned slot_size = sizeof(header) + ceiled_data_size;
+
+        BN_ASSERT(slot_size <= unsigned(_storage->size()) / 2, "Save data size too big: ", raw_data_size);
+        ensure_no_locations_overlap(slot_size);
+        invalidate_next_location_blocks();
+        invalidate_next_location_state();
+
+        // Prepare the header, which checksum starts with the header itself
+        header hdr = make_header(raw_data_size, sram_schema_hash_of<SaveData>());
+        const int location = next_location();
+        {
+            IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+            erase_location(location, slot_size);
+        }
+        sram_sink sink(*_storage, location + sizeof(header), header_checksum(hdr));
+
+        // Serialize from save data to the SRAM, chunk by chunk
+        bit_stream_writer::word_type chunk[STREAM_CHUNK_WORDS];
+        bit_stream_writer writer(bn::span<bit_stream_writer::word_type>(chunk, STREAM_CHUNK_WORDS), raw_data_size,
+                                 sink);
+        {
+            IBN_STATS_SRAM_RW_PHASE(SERIALIZE);
+            save_data.write(writer);
+            writer.flush_final();
+        }
+
+        // User must have correctly serialized their save data to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing save data");
+
+        // Write the header last, so that this location is valid only after all the data is written
+        hdr.checksum = sink.checksum();
+        {
+            IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+            write_header_at(location, hdr);
+        }
+
+        commit_next_location(hdr);
+    }
+
+    /// @brief Writes only the changed blocks of the save data to the SRAM.
+    ///
+    /// This remembers the crc32 checksum of each `IBN_CFG_SRAM_RW_INCREMENTAL_BLOCK_SIZE` bytes block
+    /// written to each location, and skips writing the blocks whose checksum is unchanged. \n
+    /// So, if only a few fields changed since the last save, only a few blocks and the header are written. \n
+    /// The header is written last, as with `write_streamed()`, and the saved format is the same as `write()`.
+    ///
+    /// @note The first incremental write to each location writes all the blocks,
+    /// as the contents of the locations are unknown until then. \n
+    /// Also, this assumes that this `sram_rw` is the only one writing to its locations. \n
+    /// If the storage needs erasing, all the blocks are always written, as the location is erased beforehand.
+    /// @note Block checksums of both locations take `2 * 4 * (storage size / 2 / block size)` bytes on the heap,
+    /// which are allocated on the first call.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be saved.
+    /// @return Number of save data bytes actually written to the SRAM, excluding the header.
+    template <sram_save_data SaveData>
+    auto write_incremental(const SaveData& save_data) -> unsigned
+    {
+        BN_ASSERT(done(), "Background write in progress");
+
+        // Measure how much space required
+        IBN_STATS_SRAM_RW_BEGIN_SAVE;
+        bit_stream_measurer measurer;
+        {
+            IBN_STATS_SRAM_RW_PHASE(MEASURE);
+            save_data.measure(measurer);
+        }
+
+        const unsigned raw_data_size = measurer.used_bytes();
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
+        const unsigned slot_size = sizeof(header) + ceiled_data_size;
+
+        BN_ASSERT(slot_size <= unsigned(_storage->size()) / 2, "Save data size too big: ", raw_data_size);
+        ensure_no_locations_overlap(slot_size);
+        invalidate_next_location_state();
+
+        // Erasing wipes the previous blocks, so all the blocks are written again
+        const int location = next_location();
+        const int index = next_location_index();
+        {
+            IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+            if (erase_location(location, slot_size))
+                _blocks_counts[index] = 0;
+        }
+
+        // Prepare the header, which checksum starts with the header itself
+        header hdr = make_header(raw_data_size, sram_schema_hash_of<SaveData>());
+        incremental_sram_sink sink(*_storage, location + sizeof(header), header_checksum(hdr), block_crc32s_of(index),
+                                   _blocks_counts[index]);
+
+        // Blocks are unknown while being written
+        _blocks_counts[index] = 0;
+
+        // Serialize from save data to the SRAM, block by block
+        bit_stream_writer::word_type block[BLOCK_WORDS];
+        bit_stream_writer writer(bn::span<bit_stream_writer::word_type>(block, BLOCK_WORDS), raw_data_size, sink);
+        {
+            IBN_STATS_SRAM_RW_PHASE(SERIALIZE);
+            save_data.write(writer);
+            writer.flush_final();
+        }
+
+        // User must have correctly serialized their save data to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing save data");
+
+        // Write the header last, so that this location is valid only after all the data is written
+        hdr.checksum = sink.checksum();
+        {
+            IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+            write_header_at(location, hdr);
+        }
+
+        _blocks_counts[index] = sink.blocks_count();
+        commit_next_location(hdr);
+
+        return sink.written_bytes();
+    }
+
+    /// @brief Starts writing the save data to the SRAM in the background, across multiple frames.
+    ///
+    /// The save data is serialized to a heap buffer right away, so it can be modified after this call. \n
+    /// Then, each `update()` writes some bytes of it to the SRAM, and the header is written last. \n
+    /// Until then, `read()` keeps loading the previous save, so a power loss in the middle is safe.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be saved.
+    template <sram_save_data SaveData>
+    void begin_write(const SaveData& save_data)
+    {
+        BN_ASSERT(done(), "Background write in progress");
+
+        // Measure how much space required
+        IBN_STATS_SRAM_RW_BEGIN_SAVE;
+        bit_stream_measurer measurer;
+        {
+            IBN_STATS_SRAM_RW_PHASE(MEASURE);
+            save_data.measure(measurer);
+        }
+
+        const unsigned raw_data_size = measurer.used_bytes();
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
+        const unsigned buffer_size = sizeof(header) + ceiled_data_size;
+
+        BN_ASSERT(buffer_size <= unsigned(_storage->size()) / 2, "Save data size too big: ", raw_data_size);
+        ensure_no_locations_overlap(buffer_size);
+        invalidate_next_location_blocks();
+        invalidate_next_location_state();
+
+        // Allocate the buffer, which is kept until the write is done (aligned to 4 bytes)
+        std::uint8_t* buffer = new std::uint8_t[buffer_size];
+
         // Serialize from save data to the buffer
         bn::span<bit_stream_writer::word_type> data_span(
             reinterpret_cast<bit_stream_writer::word_type*>(buffer + sizeof(header)),
             ceiled_data_size / sizeof(bit_stream_writer::word_type));
         bit_stream_writer writer(data_span, raw_data_size);
-        save_data.write(writer);
-        writer.flush_final();
+        {
+            IBN_STATS_SRAM_RW_PHASE(SERIALIZE);
+            save_data.write(writer);
+            writer.flush_final();
+        }
 
         // User must have correctly serialized their save data to `writer`
         BN_ASSERT(!writer.fail(), "Error serializing save data");
 
         // Write the header
-        bn::span<std::uint8_t> buffer_span(buffer, buffer_size);
-        write_header(buffer_span, raw_data_size);
+        {
+            IBN_STATS_SRAM_RW_PHASE(CHECKSUM);
+            write_header(bn::span<std::uint8_t>(buffer, buffer_size), raw_data_size, sram_schema_hash_of<SaveData>());
+        }
 
-        // Store to SRAM
-        if (next_sequence() % 2 == 0)
-            bn::sram::write_span_offset(buffer_span, _location_0);
-        else
-            bn::sram::write_span_offset(buffer_span, _location_1);
+        _pending_buffer = buffer;
+        _pending_size = buffer_size;
+        _pending_written = 0;
+        _pending_location = next_location();
+        _pending_erased = false;
+    }
 
-        // Deallocate temporary buffer
-        if (!use_stack_buffer)
-            delete[] buffer;
+    /// @brief Writes some bytes of the background write started with `begin_write()`. \n
+    /// Call this once per frame until `done()` returns `true`.
+    /// @note The header is written only after all the data is written, in the last call. \n
+    /// If the storage needs erasing, the first call erases the location before writing anything.
+    /// @param max_bytes Maximum number of save data bytes to write in this call.
+    void update(unsigned max_bytes = DEFAULT_UPDATE_BYTES);
 
-        increase_next_sequence();
+    /// @brief Indicates if there's no background write in progress.
+    bool done() const
+    {
+        return _pending_buffer == nullptr;
     }
 
-#pragma GCC diagnostic pop
-
     /// @brief Reads the save data from the SRAM.
     /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
     /// heap.
@@ -137,58 +577,133 @@ public:
     template <sram_save_data SaveData>
     bool read(SaveData& save_data, unsigned max_stack_buffer_size = DEFAULT_ALLOCA_SIZE)
     {
-        // Look at both locations for headers to find the recent save
-        header header_0 = read_header_at(_location_0);
-        header header_1 = read_header_at(_location_1);
+        return read_recent([&](int location, const header& header_, bool validated) {
+            return read_at(save_data, location, header_, validated, max_stack_buffer_size);
+        });
+    }
 
-        if (validate_header(header_0) && validate_header(header_1))
+    /// @brief Reads the save data from the SRAM, using the caller-provided scratch buffer instead of allocating one.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be loaded.
+    /// @param scratch Scratch buffer, which must be `required_scratch_bytes()` of the biggest save data or more. \n
+    /// A save that doesn't fit in it is treated as invalid.
+    /// @return Whether the save data has been loaded or not.
+    template <sram_save_data SaveData>
+    bool read(SaveData& save_data, bn::span<bit_stream_reader::word_type> scratch)
+    {
+        return read_recent([&](int location, const header& header_, bool validated) {
+            if (occupied_bytes(header_.data_size) > unsigned(scratch.size_bytes()))
+                return false;
+
+            return read_with_buffer(save_data, location, header_, validated,
+                                    reinterpret_cast<std::uint8_t*>(scratch.data()));
+        });
+    }
+
+    /// @brief Reads the save data from the SRAM, without copying it to a temporary buffer first.
+    ///
+    /// The checksum is validated first by reading the SRAM chunk by chunk, unless it's already validated. \n
+    /// Then, the save data is deserialized straight into the @p save_data while being read chunk by chunk again,
+    /// without any temporary `SaveData` instance. (`IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE` bytes on the stack)
+    /// @note So, a save that isn't validated yet is read twice, which trades the read time for the memory. \n
+    /// A corrupted save is never deserialized, as with `read()`.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be loaded.
+    /// @return Whether the save data has been loaded or not.
+    template <sram_save_data SaveData>
+    bool read_streamed(SaveData& save_data)
+    {
+        return read_recent([&](int location, const header& header_, bool validated) {
+            return read_streamed_at(save_data, location, header_, validated);
+        });
+    }
+
+private:
+    // Calls `read_at(location, header, validated)` with the recent save first, and then the older one if it fails.
+    template <typename ReadAt>
+    bool read_recent(ReadAt&& read_at)
+    {
+        // Look at both locations for headers to find the recent save (or use the cached ones)
+        header headers[2];
+        const bool candidates[2] = {candidate_header(0, headers[0]), candidate_header(1, headers[1])};
+
+        const int recent_index =
+            (candidates[0] && (!candidates[1] || sequence_greater_than(headers[0].sequence, headers[1].sequence))) ? 0
+                                                                                                                    : 1;
+        const int indexes[2] = {recent_index, 1 - recent_index};
+
+        for (const int index : indexes)
         {
-            const bool recent_is_0 = sequence_greater_than(header_0.sequence, header_1.sequence);
-            if (recent_is_0)
-            {
-                if (read_at(save_data, _location_0, header_0, max_stack_buffer_size))
-                    return true;
-                else
-                    return read_at(save_data, _location_1, header_1, max_stack_buffer_size);
-            }
-            else
+            if (!candidates[index])
+                continue;
+
+            const bool validated = _location_states[index] == location_state::VALID;
+            if (read_at(location_of(index), headers[index], validated))
             {
-                if (read_at(save_data, _location_1, header_1, max_stack_buffer_size))
-                    return true;
-                else
-                    return read_at(save_data, _location_0, header_0, max_stack_buffer_size);
+                // Checksum has been validated while reading
+                _location_states[index] = location_state::VALID;
+                _cached_headers[index] = headers[index];
+                return true;
             }
         }
-        else if (validate_header(header_0))
-        {
-            return read_at(save_data, _location_0, header_0, max_stack_buffer_size);
-        }
-        else if (validate_header(header_1))
-        {
-            return read_at(save_data, _location_1, header_1, max_stack_buffer_size);
-        }
 
         return false;
     }
 
+    template <sram_save_data SaveData>
+    bool read_streamed_at(SaveData& save_data, const int location, const header& header_, bool validated)
+    {
+        if (header_.schema_hash != sram_schema_hash_of<SaveData>())
+            return false;
+
+        const unsigned data_location = location + header_size(header_);
+        const unsigned raw_data_size = header_.data_size;
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(raw_data_size);
+
+        if (data_location + ceiled_data_size > unsigned(_storage->size()))
+            return false;
+
+        // Validate checksum first, if not validated yet
+        if (!validated && !validate_checksum_at(location, header_))
+            return false;
+
+        // Deserialize to the save data directly, while reading from the storage chunk by chunk
+        sram_source source(*_storage, data_location, ceiled_data_size / sizeof(bit_stream_reader::word_type));
+        bit_stream_reader::word_type chunk[STREAM_CHUNK_WORDS];
+        bn::span<bit_stream_reader::word_type> chunk_span(chunk, STREAM_CHUNK_WORDS);
+
+        bit_stream_reader reader(chunk_span, raw_data_size, source);
+        save_data.read(reader);
+
+        if (reader.fail() || reader.unused_bytes() != 0)
+            return false;
+
+        _next_sequence = header_.sequence + 1;
+
+        return true;
+    }
+
 private:
     auto read_header_at(const int location) -> header;
+    void write_header_at(const int location, const header& header_);
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstack-usage="
 
     template <sram_save_data SaveData>
-    bool read_at(SaveData& save_data, const int location, const header& header_, unsigned max_stack_buffer_size)
+    bool read_at(SaveData& save_data, const int location, const header& header_, bool validated,
+                 unsigned max_stack_buffer_size)
     {
-        const unsigned data_location = location + sizeof(header);
-        const unsigned raw_data_size = header_.data_size;
-        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(raw_data_size);
+        // Reject another schema before allocating
+        if (header_.schema_hash != sram_schema_hash_of<SaveData>())
+            return false;
+
+        const unsigned buffer_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header_.data_size);
 
-        if (data_location + ceiled_data_size > SRAM_SIZE)
+        if (location + header_size(header_) + buffer_size > unsigned(_storage->size()))
             return false;
 
         // `alloca()` on small sizes
-        const unsigned buffer_size = sizeof(header) + ceiled_data_size;
         const bool use_stack_buffer = buffer_size <= max_stack_buffer_size;
 
         // Allocate temporary buffer (both would be aligned to 4 bytes)
@@ -198,62 +713,175 @@ private:
         else
             buffer = new std::uint8_t[buffer_size];
 
+        const bool success = read_with_buffer(save_data, location, header_, validated, buffer);
+
+        // Deallocate temporary buffer
+        if (!use_stack_buffer)
+            delete[] buffer;
+
+        return success;
+    }
+
+#pragma GCC diagnostic pop
+
+    // `buffer` must be the data size ceiled to words or more, aligned to 4 bytes.
+    // (The header is not copied to it, as the checksum is calculated from the header itself.)
+    template <sram_save_data SaveData>
+    bool read_with_buffer(SaveData& save_data, const int location, const header& header_, bool validated,
+                          std::uint8_t* buffer)
+    {
+        if (header_.schema_hash != sram_schema_hash_of<SaveData>())
+            return false;
+
+        const unsigned data_location = location + header_size(header_);
+        const unsigned raw_data_size = header_.data_size;
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(raw_data_size);
+
+        if (data_location + ceiled_data_size > unsigned(_storage->size()))
+            return false;
+
         // Read to the temporary buffer
-        bn::span<std::uint8_t> read_data_span(buffer + sizeof(header), ceiled_data_size);
-        bn::sram::read_span_offset(read_data_span, data_location);
+        bn::span<std::uint8_t> read_data_span(buffer, ceiled_data_size);
+        _storage->read(data_location, read_data_span);
 
-        // Validate crc32 checksum
-        bn::span<std::uint8_t> crc32_span(buffer + sizeof(std::uint32_t),
-                                          sizeof(header) - sizeof(std::uint32_t) + ceiled_data_size);
-        bn::memcpy(crc32_span.data(), reinterpret_cast<const std::uint8_t*>(&header_) + sizeof(std::uint32_t),
-                   sizeof(header) - sizeof(std::uint32_t));
-        const std::uint32_t crc32 = crc32_fast(crc32_span.data(), crc32_span.size_bytes());
-        bool success = crc32 == header_.crc32;
+        // Validate checksum, if not validated yet
+        bool success = true;
+        if (!validated)
+            success = header_checksum(header_).update(read_data_span).value() == header_.checksum;
 
         if (success)
         {
             // Deserialize to the `save_data`
-            bn::span<const std::uint32_t> data_span(
-                reinterpret_cast<const bit_stream_reader::word_type*>(buffer + sizeof(header)),
-                ceiled_data_size / sizeof(bit_stream_reader::word_type));
+            bn::span<const std::uint32_t> data_span(reinterpret_cast<const bit_stream_reader::word_type*>(buffer),
+                                                    ceiled_data_size / sizeof(bit_stream_reader::word_type));
             bit_stream_reader reader(data_span, raw_data_size);
             save_data.read(reader);
             success = !reader.fail() && reader.unused_bytes() == 0;
         }
 
-        // Deallocate temporary buffer
-        if (!use_stack_buffer)
-            delete[] buffer;
-
         if (success)
             _next_sequence = header_.sequence + 1;
 
         return success;
     }
 
-#pragma GCC diagnostic pop
+    // `buffer` must be `occupied_bytes(raw_data_size)` bytes or more, aligned to 4 bytes.
+    template <sram_save_data SaveData>
+    void write_with_buffer(const SaveData& save_data, unsigned raw_data_size, std::uint8_t* buffer)
+    {
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
+        const unsigned buffer_size = sizeof(header) + ceiled_data_size;
+
+        ensure_no_locations_overlap(buffer_size);
+        invalidate_next_location_blocks();
+        invalidate_next_location_state();
+
+        // Serialize from save data to the buffer
+        bn::span<bit_stream_writer::word_type> data_span(
+            reinterpret_cast<bit_stream_writer::word_type*>(buffer + sizeof(header)),
+            ceiled_data_size / sizeof(bit_stream_writer::word_type));
+        bit_stream_writer writer(data_span, raw_data_size);
+        {
+            IBN_STATS_SRAM_RW_PHASE(SERIALIZE);
+            save_data.write(writer);
+            writer.flush_final();
+        }
+
+        // User must have correctly serialized their save data to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing save data");
+
+        // Write the header
+        bn::span<std::uint8_t> buffer_span(buffer, buffer_size);
+        {
+            IBN_STATS_SRAM_RW_PHASE(CHECKSUM);
+            write_header(buffer_span, raw_data_size, sram_schema_hash_of<SaveData>());
+        }
+
+        // Store to the storage
+        const int location = next_location();
+        {
+            IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+            erase_location(location, buffer_size);
+            _storage->write(location, buffer_span);
+        }
+
+        commit_next_location(*reinterpret_cast<const header*>(buffer));
+    }
 
 private:
     // Not a full check
-    // (can't check crc32 without looking at data)
+    // (can't check checksum without looking at data)
     bool validate_header(const header&) const;
 
+    // Full check, which reads the data chunk by chunk
+    bool validate_checksum_at(int location, const header&) const;
+
+    void ensure_valid_locations() const;
     void ensure_no_locations_overlap(int size) const;
 
+    // Erases the erase blocks of the location that `size` bytes would be written to.
+    // Returns whether the storage needs erasing or not.
+    bool erase_location(int location, int size);
+
     auto next_sequence() const -> std::uint8_t;
     void increase_next_sequence();
 
-    void write_header(bn::span<std::uint8_t> span, bit_stream_writer::size_type logical_bytes_length);
+    auto next_location() const -> int;
+    auto next_location_index() const -> int;
+    auto location_of(int location_index) const -> int;
+
+    // Index of the recent location validated by the cache, or `-1` if none
+    auto recent_valid_index() const -> int;
+
+    // Gets the header of the location to try reading, which is cached if the location is already validated
+    bool candidate_header(int location_index, header& header_);
 
-    static bool sequence_greater_than(std::uint8_t a, std::uint8_t b);
+    // Marks the next location as invalid, as it's about to be overwritten
+    void invalidate_next_location_state();
+
+    // Caches the header written to the next location, and moves to the other location
+    void commit_next_location(const header& header_);
+
+    auto max_blocks() const -> unsigned;
+    auto block_crc32s_of(int location_index) -> std::uint32_t*;
+    void invalidate_next_location_blocks();
+
+    // Prepares the header without checksum
+    auto make_header(bit_stream_writer::size_type logical_bytes_length, std::uint32_t schema_hash) const -> header;
+    void write_header(bn::span<std::uint8_t> span, bit_stream_writer::size_type logical_bytes_length,
+                      std::uint32_t schema_hash);
+
+    // Checksum of the header fields after the checksum itself, with the algorithm recorded in the header
+    static auto header_checksum(const header&) -> checksum_stream;
+
+    // Size of the header on the storage, which the data follows
+    static auto header_size(const header&) -> unsigned;
 
 private:
+    storage* _storage;
+
     const int _location_0;
     const int _location_1;
 
     std::uint8_t _magic[MAGIC_LEN];
+    const checksum_kind _checksum_kind;
 
     bn::optional<std::uint8_t> _next_sequence;
+
+    // Background write states
+    std::uint8_t* _pending_buffer = nullptr;
+    unsigned _pending_size = 0;
+    unsigned _pending_written = 0;
+    int _pending_location = 0;
+    bool _pending_erased = false;
+
+    // Cached states of the locations
+    location_state _location_states[2] = {};
+    header _cached_headers[2];
+
+    // Incremental write states (`[2][max_blocks()]` block checksums, and their valid counts per location)
+    std::uint32_t* _block_crc32s = nullptr;
+    unsigned _blocks_counts[2] = {};
 };
 
 } // namespace ibn
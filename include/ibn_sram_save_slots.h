@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_bit_stream.h"
+#include "ibn_sram_rw.h"
+#include "ibn_storage.h"
+
+#include <bn_assert.h>
+#include <bn_string_view.h>
+
+#include <cstdint>
+#include <utility>
+
+namespace ibn
+{
+
+/// @brief Manages multiple save slots (e.g. "File 1/2/3") on the SRAM, with a directory of their summaries.
+///
+/// Each save slot is stored with its own `sram_rw`, so each of them is double buffered. \n
+/// Along with them, the summary of each save slot (e.g. play time, chapter) is stored in a small directory,
+/// which is also stored with `sram_rw`. \n
+/// So, a file select screen only needs to `load_directory()`,
+/// without reading or validating the save data of every save slot.
+///
+/// SRAM layout from the `location`: `[directory x 2][slot 0 x 2][slot 1 x 2]...`
+///
+/// @note The directory is written right after the save data. \n
+/// If the power is lost between them, the directory keeps showing the previous summary of that save slot.
+/// @tparam Summary Summary class that satisfies `sram_save_data` concept, which must be default constructible.
+/// @tparam SlotsCount Number of save slots.
+template <sram_save_data Summary, int SlotsCount>
+class sram_save_slots final
+{
+    static_assert(SlotsCount > 0);
+
+private:
+    // Directory of the save slots, which is the save data of `_directory_rw`.
+    struct directory final
+    {
+        bool used[SlotsCount] = {};
+        Summary summaries[SlotsCount] = {};
+
+        void measure(bit_stream_measurer& measurer) const
+        {
+            for (int slot = 0; slot < SlotsCount; ++slot)
+            {
+                measurer.write(used[slot]);
+                if (used[slot])
+                    summaries[slot].measure(measurer);
+            }
+        }
+
+        void write(bit_stream_writer& writer) const
+        {
+            for (int slot = 0; slot < SlotsCount; ++slot)
+            {
+                writer.write(used[slot]);
+                if (used[slot])
+                    summaries[slot].write(writer);
+            }
+        }
+
+        void read(bit_stream_reader& reader)
+        {
+            for (int slot = 0; slot < SlotsCount; ++slot)
+            {
+                reader.read(used[slot]);
+                if (used[slot])
+                    summaries[slot].read(reader);
+            }
+        }
+    };
+
+public:
+    /// @brief Constructor.
+    /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
+    /// @param location SRAM location of the directory, which is followed by the save slots.
+    /// @param directory_capacity Number of SRAM bytes of each directory location.
+    /// @param slot_capacity Number of SRAM bytes of each save slot location.
+    /// @param storage_ Storage to store the directory and the save slots, which must outlive this. \n
+    /// If it needs erasing, the location and both capacities must be aligned to its erase block size.
+    sram_save_slots(bn::string_view magic, unsigned location, unsigned directory_capacity, unsigned slot_capacity,
+                    storage& storage_ = sram_storage::instance())
+        : sram_save_slots(magic, location, directory_capacity, slot_capacity, storage_,
+                          std::make_integer_sequence<int, SlotsCount>())
+    {
+    }
+
+public:
+    /// @brief Gets the number of save slots.
+    static constexpr int slots_count()
+    {
+        return SlotsCount;
+    }
+
+    /// @brief Gets the number of SRAM bytes the directory and all the save slots occupy.
+    auto size_bytes() const -> unsigned
+    {
+        return 2 * _directory_capacity + SlotsCount * 2 * _slot_capacity;
+    }
+
+    /// @brief Loads the directory, without reading the save data of any save slot.
+    /// @return Whether the directory has been loaded or not. \n
+    /// If not, all the save slots are treated as empty.
+    bool load_directory()
+    {
+        // Failed read doesn't continue the sequence, so the next write still scans
+        if (_directory_rw.read(_directory))
+        {
+            _directory_sequence_resumed = true;
+            return true;
+        }
+
+        _directory = directory();
+        return false;
+    }
+
+    /// @brief Indicates if the save slot has a save or not, according to the directory.
+    bool has_save(int slot) const
+    {
+        BN_ASSERT(slot >= 0 && slot < SlotsCount, "Invalid slot: ", slot);
+
+        return _directory.used[slot];
+    }
+
+    /// @brief Gets the summary of the save slot from the directory.
+    /// @note This is only meaningful if `has_save()` is `true`.
+    auto summary(int slot) const -> const Summary&
+    {
+        BN_ASSERT(slot >= 0 && slot < SlotsCount, "Invalid slot: ", slot);
+
+        return _directory.summaries[slot];
+    }
+
+    /// @brief Reads the save data of the save slot.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param slot Save slot to read.
+    /// @param save_data Save data to be loaded.
+    /// @return Whether the save data has been loaded or not.
+    template <sram_save_data SaveData>
+    bool read(int slot, SaveData& save_data)
+    {
+        BN_ASSERT(slot >= 0 && slot < SlotsCount, "Invalid slot: ", slot);
+
+        if (!_directory.used[slot])
+            return false;
+
+        // Failed read doesn't continue the sequence, so the next write still scans
+        if (!_slot_rws[slot].read(save_data))
+            return false;
+
+        _sequence_resumed[slot] = true;
+        return true;
+    }
+
+    /// @brief Writes the save data to the save slot, and its summary to the directory.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param slot Save slot to write.
+    /// @param save_data Save data to be saved.
+    /// @param summary Summary of the save data.
+    template <sram_save_data SaveData>
+    void write(int slot, const SaveData& save_data, const Summary& summary)
+    {
+        BN_ASSERT(slot >= 0 && slot < SlotsCount, "Invalid slot: ", slot);
+
+        bit_stream_measurer measurer;
+        save_data.measure(measurer);
+        BN_ASSERT(sram_rw::occupied_bytes(measurer.used_bytes()) <= _slot_capacity,
+                  "Save data size too big for the slot: ", measurer.used_bytes());
+
+        // Don't overwrite the recent save of the slot
+        if (!_sequence_resumed[slot])
+        {
+            _slot_rws[slot].resume_sequence();
+            _sequence_resumed[slot] = true;
+        }
+
+        _slot_rws[slot].write_streamed(save_data);
+
+        _directory.used[slot] = true;
+        _directory.summaries[slot] = summary;
+        write_directory();
+    }
+
+    /// @brief Marks the save slot as empty in the directory.
+    /// @note The save data itself is left as-is, but it can't be read with this anymore.
+    void erase(int slot)
+    {
+        BN_ASSERT(slot >= 0 && slot < SlotsCount, "Invalid slot: ", slot);
+
+        _directory.used[slot] = false;
+        _directory.summaries[slot] = Summary();
+        write_directory();
+    }
+
+private:
+    template <int... Slots>
+    sram_save_slots(bn::string_view magic, unsigned location, unsigned directory_capacity, unsigned slot_capacity,
+                    storage& storage_, std::integer_sequence<int, Slots...>)
+        : _directory_rw(magic, location, location + directory_capacity, storage_),
+          _slot_rws{sram_rw(magic, slot_location(location, directory_capacity, slot_capacity, Slots),
+                            slot_location(location, directory_capacity, slot_capacity, Slots) + slot_capacity,
+                            storage_)...},
+          _directory_capacity(directory_capacity), _slot_capacity(slot_capacity)
+    {
+        BN_ASSERT(location + size_bytes() <= unsigned(storage_.size()), "Save slots too big: ", size_bytes(),
+                  " bytes at ", location);
+    }
+
+    static constexpr auto slot_location(unsigned location, unsigned directory_capacity, unsigned slot_capacity,
+                                        int slot) -> unsigned
+    {
+        return location + 2 * directory_capacity + slot * 2 * slot_capacity;
+    }
+
+    void write_directory()
+    {
+        bit_stream_measurer measurer;
+        _directory.measure(measurer);
+        BN_ASSERT(sram_rw::occupied_bytes(measurer.used_bytes()) <= _directory_capacity,
+                  "Directory size too big: ", measurer.used_bytes());
+
+        if (!_directory_sequence_resumed)
+        {
+            _directory_rw.resume_sequence();
+            _directory_sequence_resumed = true;
+        }
+
+        _directory_rw.write_streamed(_directory);
+    }
+
+private:
+    sram_rw _directory_rw;
+    sram_rw _slot_rws[SlotsCount];
+
+    const unsigned _directory_capacity;
+    const unsigned _slot_capacity;
+
+    directory _directory;
+
+    bool _directory_sequence_resumed = false;
+    bool _sequence_resumed[SlotsCount] = {};
+};
+
+} // namespace ibn
@@ -0,0 +1,252 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_bit_stream.h"
+#include "ibn_ceil_to_multiple_of.h"
+#include "ibn_checksum.h"
+#include "ibn_crc32.h"
+#include "ibn_sram_rw.h"
+#include "ibn_storage.h"
+
+#include <bn_assert.h>
+#include <bn_span.h>
+#include <bn_string_view.h>
+
+#include <cstdint>
+
+#ifndef IBN_CFG_SRAM_WEAR_LEVELED_RW_MAX_SECTORS
+#define IBN_CFG_SRAM_WEAR_LEVELED_RW_MAX_SECTORS 16
+#endif
+
+namespace ibn
+{
+
+/// @brief Save data reader & writer that spreads the saves over multiple sectors, for Flash-style storages.
+///
+/// Unlike `sram_rw`, which erases one of its two locations on every write,
+/// this appends each save after the previous one in the current sector,
+/// and erases a sector only when the current one gets full. \n
+/// So, a sector of `sector_size` bytes is erased once per `sector_size / save size` saves,
+/// and the erases are spread evenly by moving to the least erased sector each time.
+///
+/// Each sector stores its own erase count, and each save is protected with its own crc32 checksum. \n
+/// A save torn by a power loss is ignored, and the previous save is loaded instead.
+///
+/// @note The sectors are scanned on the first `read()` or `write()`, which reads all the saves in them once.
+class sram_wear_leveled_rw final
+{
+private:
+    static constexpr unsigned MAGIC_LEN = 5;
+    static constexpr int MAX_SECTORS = IBN_CFG_SRAM_WEAR_LEVELED_RW_MAX_SECTORS;
+    static constexpr unsigned STREAM_CHUNK_WORDS =
+        IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE / sizeof(bit_stream_writer::word_type);
+
+    struct sector_header final
+    {
+        // checksum includes the headers below
+        std::uint32_t crc32;
+        std::uint32_t erase_count;
+        std::uint8_t magic[MAGIC_LEN];
+        std::uint8_t padding[3];
+    };
+
+    struct record_header final
+    {
+        // checksum includes not only data, but also headers below
+        std::uint32_t crc32;
+        std::uint32_t sequence;
+        std::uint16_t data_size;
+        std::uint16_t padding;
+    };
+
+    static_assert(sizeof(sector_header) % sizeof(bit_stream_writer::word_type) == 0,
+                  "Sector header makes records not aligned to bit stream words");
+    static_assert(sizeof(record_header) % sizeof(bit_stream_writer::word_type) == 0,
+                  "Record header makes data portion not aligned to bit stream words");
+
+    // Writes the flushed words to the storage, while updating the crc32 checksum.
+    class record_sink final : public bit_stream_sink
+    {
+    public:
+        record_sink(storage& storage_, int location, std::uint32_t crc32);
+
+        void consume(bn::span<const bit_stream_writer::word_type> words) override;
+
+        auto crc32() const -> std::uint32_t
+        {
+            return _crc32.value();
+        }
+
+    private:
+        storage* _storage;
+        int _location;
+        checksum_stream _crc32;
+    };
+
+    // Reads the words of an already validated record from the storage.
+    class record_source final : public bit_stream_source
+    {
+    public:
+        record_source(storage& storage_, int location, unsigned words_count);
+
+        void fetch(bit_stream_reader::size_type first_word_index, bn::span<bit_stream_reader::word_type> words) override;
+
+    private:
+        storage* _storage;
+        int _location;
+        unsigned _words_count;
+    };
+
+public:
+    /// @brief Constructor.
+    /// @param magic Magic string to uniquely distinguish your game (i.e. Game Code). Must be 5 bytes.
+    /// @param location Storage location of the first sector.
+    /// @param sector_size Size of each sector in bytes, which must be a multiple of the erase block size.
+    /// @param sectors_count Number of sectors, which must be at least 2.
+    /// @param storage_ Storage to store the save data, which must outlive this.
+    sram_wear_leveled_rw(bn::string_view magic, unsigned location, unsigned sector_size, int sectors_count,
+                         storage& storage_ = sram_storage::instance());
+
+public:
+    /// @brief Gets the number of sectors.
+    auto sectors_count() const -> int
+    {
+        return _sectors_count;
+    }
+
+    /// @brief Gets the size of each sector in bytes.
+    auto sector_size() const -> unsigned
+    {
+        return _sector_size;
+    }
+
+    /// @brief Gets the max save data size in bytes, which fits in a sector.
+    auto max_data_size() const -> unsigned
+    {
+        return _sector_size - sizeof(sector_header) - sizeof(record_header);
+    }
+
+    /// @brief Gets the number of times the sector has been erased.
+    /// @note If the erase count of the sector has been lost (e.g. power loss right after erasing),
+    /// it's assumed to be the biggest erase count of the other sectors.
+    auto erase_count(int sector) -> unsigned;
+
+    /// @brief Reads the most recent save data.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be loaded.
+    /// @return Whether the save data has been loaded or not.
+    template <sram_save_data SaveData>
+    bool read(SaveData& save_data)
+    {
+        scan();
+
+        if (_recent_location < 0)
+            return false;
+
+        // Deserialize while reading from the storage chunk by chunk, as the checksum has been validated on scan
+        const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(_recent_data_size);
+        record_source source(*_storage, _recent_location + sizeof(record_header),
+                             ceiled_data_size / sizeof(bit_stream_reader::word_type));
+        bit_stream_reader::word_type chunk[STREAM_CHUNK_WORDS];
+
+        bit_stream_reader reader(bn::span<bit_stream_reader::word_type>(chunk, STREAM_CHUNK_WORDS), _recent_data_size,
+                                 source);
+        save_data.read(reader);
+
+        return !reader.fail() && reader.unused_bytes() == 0;
+    }
+
+    /// @brief Writes the save data after the most recent one.
+    ///
+    /// If it doesn't fit in the rest of the current sector, the least erased other sector is erased and used. \n
+    /// The save data is serialized in small chunks (`IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE` bytes on the stack),
+    /// and its header is written last.
+    /// @tparam SaveData Save data class that satisfies `sram_save_data` concept.
+    /// @param save_data Save data to be saved, which must be `max_data_size()` bytes or less.
+    template <sram_save_data SaveData>
+    void write(const SaveData& save_data)
+    {
+        // Measure how much space required
+        bit_stream_measurer measurer;
+        save_data.measure(measurer);
+
+        const unsigned raw_data_size = measurer.used_bytes();
+        BN_ASSERT(raw_data_size <= max_data_size(), "Save data size too big: ", raw_data_size);
+
+        const unsigned record_size =
+            sizeof(record_header) + ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(raw_data_size);
+        const int location = prepare_record_location(record_size);
+
+        // Prepare the header, which checksum starts with the header itself
+        record_header header = make_record_header(raw_data_size);
+        record_sink sink(*_storage, location + sizeof(record_header), record_header_crc32(header));
+
+        // Serialize from save data to the storage, chunk by chunk
+        bit_stream_writer::word_type chunk[STREAM_CHUNK_WORDS];
+        bit_stream_writer writer(bn::span<bit_stream_writer::word_type>(chunk, STREAM_CHUNK_WORDS), raw_data_size,
+                                 sink);
+        save_data.write(writer);
+        writer.flush_final();
+
+        // User must have correctly serialized their save data to `writer`
+        BN_ASSERT(!writer.fail(), "Error serializing save data");
+
+        // Write the header last, so that this record is valid only after all the data is written
+        header.crc32 = sink.crc32();
+        commit_record(location, header);
+    }
+
+private:
+    // Finds the most recent record & the erase counts of the sectors, if not scanned yet
+    void scan();
+
+    // Scans the records of the sector, and updates the most recent record with them
+    void scan_sector(int sector);
+
+    // Full check of the record, which reads the data chunk by chunk
+    bool validate_record(int location, const record_header&) const;
+
+    // Checks if the bytes in `[location, end)` are erased, on a storage that needs erasing
+    bool erased(int location, int end) const;
+
+    // Gets the location to write the record, erasing the next sector if it doesn't fit in the current one
+    auto prepare_record_location(unsigned record_size) -> int;
+
+    // Least erased sector other than the current one
+    auto next_sector() const -> int;
+    void erase_sector(int sector);
+
+    auto make_record_header(unsigned data_size) const -> record_header;
+    void commit_record(int location, const record_header&);
+
+    auto sector_location(int sector) const -> int;
+    static auto sector_header_crc32(const sector_header&) -> std::uint32_t;
+    static auto record_header_crc32(const record_header&) -> std::uint32_t;
+
+private:
+    storage* _storage;
+
+    const int _location;
+    const unsigned _sector_size;
+    const int _sectors_count;
+
+    std::uint8_t _magic[MAGIC_LEN];
+
+    unsigned _erase_counts[MAX_SECTORS] = {};
+    bool _erase_count_valid[MAX_SECTORS] = {};
+
+    // Most recent record (`-1` location if none)
+    int _recent_location = -1;
+    std::uint32_t _recent_sequence = 0;
+    unsigned _recent_data_size = 0;
+
+    // Sector of the most recent record, and where the next record would be written in it (`-1` if none)
+    int _current_sector = -1;
+    int _append_location = -1;
+
+    bool _scanned = false;
+};
+
+} // namespace ibn
@@ -7,6 +7,15 @@
 #define IBN_CFG_STATS_ENABLED true
 #endif
 
+// Records the CPU cycles spent in each phase of the last `sram_rw` save.
+#ifndef IBN_CFG_SRAM_RW_STATS_ENABLED
+#define IBN_CFG_SRAM_RW_STATS_ENABLED false
+#endif
+
+#if IBN_CFG_SRAM_RW_STATS_ENABLED && !IBN_CFG_STATS_ENABLED
+#error "IBN_CFG_SRAM_RW_STATS_ENABLED requires IBN_CFG_STATS_ENABLED"
+#endif
+
 #if IBN_CFG_STATS_ENABLED
 // Call this once per frame.
 #define IBN_STATS_UPDATE ibn::stats::instance().update()
@@ -17,10 +26,25 @@
 #define IBN_STATS_UPDATE_IW ((void)0)
 #endif
 
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+// Call this at the beginning of a save.
+#define IBN_STATS_SRAM_RW_BEGIN_SAVE ibn::stats::instance().reset_sram_rw_cycles()
+// Times the rest of the scope as the `phase` of the save. (excluding the nested phases)
+#define IBN_STATS_SRAM_RW_PHASE(phase) \
+    const ibn::stats::sram_rw_phase_timer ibn_stats_sram_rw_phase_timer(ibn::stats::sram_rw_phase::phase)
+#else
+#define IBN_STATS_SRAM_RW_BEGIN_SAVE ((void)0)
+#define IBN_STATS_SRAM_RW_PHASE(phase) ((void)0)
+#endif
+
 #if IBN_CFG_STATS_ENABLED
 
 #include <bn_common.h>
 
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+#include <bn_timer.h>
+#endif
+
 #include <cstdint>
 
 namespace ibn
@@ -46,6 +70,42 @@ public:
     /// @brief Call this in @b every run-time function.
     void update_iw();
 
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+public:
+    enum class sram_rw_phase
+    {
+        MEASURE,       // `SaveData::measure()`
+        SERIALIZE,     // `SaveData::write()`
+        CHECKSUM,      // checksum of the header & data (`checksum_kind`)
+        STORAGE_WRITE, // erasing & writing to the storage
+
+        COUNT
+    };
+
+    /// @brief Adds the elapsed ticks during its lifetime to the phase,
+    /// excluding the ticks of the nested `sram_rw_phase_timer`s.
+    class sram_rw_phase_timer final
+    {
+    public:
+        explicit sram_rw_phase_timer(sram_rw_phase phase);
+        ~sram_rw_phase_timer();
+
+        sram_rw_phase_timer(const sram_rw_phase_timer&) = delete;
+        auto operator=(const sram_rw_phase_timer&) -> sram_rw_phase_timer& = delete;
+
+    private:
+        bn::timer _timer;
+        std::uint32_t _nested_ticks_at_start;
+        sram_rw_phase _phase;
+    };
+
+    /// @brief Clears the cycles of the previous save.
+    void reset_sram_rw_cycles();
+
+    /// @brief Adds the elapsed ticks to the phase of the current save.
+    void add_sram_rw_ticks(sram_rw_phase phase, int ticks);
+#endif
+
 private:
     volatile std::uint32_t _last_used_cpu = 0;        // %
     volatile std::uint32_t _used_ew = 0;              // max 262144
@@ -57,6 +117,13 @@ private:
     volatile std::uint16_t _used_sprite_palettes = 0; // max 256
     volatile std::uint16_t _used_bgs = 0;             // default max 4
     volatile std::uint16_t _used_sprites = 0;         // default max 128
+
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+    volatile std::uint32_t _sram_rw_cycles[int(sram_rw_phase::COUNT)] = {}; // last save
+
+    // Ticks of the finished phase timers, to exclude the nested ones
+    std::uint32_t _sram_rw_nested_ticks = 0;
+#endif
 };
 
 } // namespace ibn
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <bn_span.h>
+
+#include <cstdint>
+
+namespace ibn
+{
+
+/// @brief Save media that `sram_rw` reads from & writes to.
+///
+/// Media that need erasing before writing (e.g. Flash) report their erase block size, \n
+/// and `sram_rw` erases whole erase blocks before writing to them.
+///
+/// @note This interface is experimental, and may change without notice. \n
+/// Only the cartridge SRAM (`sram_storage`) is supported on the hardware for now. \n
+/// There's no GBA Flash driver (chip ID, sector erase, byte program, bank switch) yet,
+/// so the erase block code paths are only exercised with `memory_storage` on the host.
+class storage
+{
+public:
+    virtual ~storage() = default;
+
+    /// @brief Gets the size of the storage in bytes.
+    virtual auto size() const -> int = 0;
+
+    /// @brief Gets the erase block size in bytes. \n
+    /// `1` if the storage can be overwritten without erasing. (e.g. SRAM)
+    virtual auto erase_block_size() const -> int = 0;
+
+    /// @brief Reads the bytes from the storage.
+    /// @param offset Offset of the storage to read from.
+    /// @param bytes Bytes to read to.
+    virtual void read(int offset, bn::span<std::uint8_t> bytes) = 0;
+
+    /// @brief Writes the bytes to the storage.
+    /// @note If `erase_block_size()` is bigger than `1`, the bytes must be erased beforehand.
+    /// @param offset Offset of the storage to write to.
+    /// @param bytes Bytes to write.
+    virtual void write(int offset, bn::span<const std::uint8_t> bytes) = 0;
+
+    /// @brief Erases the bytes in the storage.
+    /// @param offset Offset of the storage to erase, which must be a multiple of `erase_block_size()`.
+    /// @param size Number of bytes to erase, which must be a multiple of `erase_block_size()`.
+    virtual void erase(int offset, int size) = 0;
+};
+
+/// @brief Storage on the cartridge SRAM, with `bn::sram`.
+class sram_storage final : public storage
+{
+public:
+    /// @brief Gets the shared instance, which is the default storage of `sram_rw`.
+    static auto instance() -> sram_storage&;
+
+public:
+    auto size() const -> int override;
+    auto erase_block_size() const -> int override;
+
+    void read(int offset, bn::span<std::uint8_t> bytes) override;
+    void write(int offset, bn::span<const std::uint8_t> bytes) override;
+    void erase(int offset, int size) override;
+};
+
+/// @brief Storage on a memory buffer, which can emulate a Flash-style erase block medium.
+///
+/// @note This is an emulation for the tests, not a driver of a real Flash chip.
+///
+/// If the erase block size is bigger than `1`, this behaves like a NOR Flash: \n
+/// erasing sets the bytes to `0xFF`, and writing can only clear bits (`1` to `0`). \n
+/// So, writing without erasing beforehand corrupts the data, as it would on a real Flash.
+///
+/// This is useful to test the save code on the host without the hardware, or to keep a save image in RAM.
+class memory_storage final : public storage
+{
+public:
+    /// @brief Constructor.
+    /// @param memory Memory buffer to use as the storage.
+    /// @param erase_block_size Erase block size in bytes. `1` to behave like a SRAM.
+    explicit memory_storage(bn::span<std::uint8_t> memory, int erase_block_size = 1);
+
+public:
+    auto size() const -> int override;
+    auto erase_block_size() const -> int override;
+
+    void read(int offset, bn::span<std::uint8_t> bytes) override;
+    void write(int offset, bn::span<const std::uint8_t> bytes) override;
+    void erase(int offset, int size) override;
+
+public:
+    /// @brief Gets the number of erase blocks erased so far.
+    auto erased_blocks_count() const -> int
+    {
+        return _erased_blocks_count;
+    }
+
+private:
+    bn::span<std::uint8_t> _memory;
+    int _erase_block_size;
+    int _erased_blocks_count = 0;
+};
+
+} // namespace ibn
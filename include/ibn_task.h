@@ -11,6 +11,7 @@
 // * Promise types are "private" by design.
 //   * Add seperate `task::result()` getters because of this.
 // * Simplify the code
+// * Add `task::release()` to hand the coroutine over to a `task_scheduler`.
 
 #pragma once
 
@@ -291,6 +292,13 @@ public:
         }
     }
 
+    /// @brief Releases the ownership of the referred coroutine, without destroying it.
+    /// After this, the task won't refer a coroutine, and the caller must destroy the returned handle.
+    [[nodiscard]] auto release() noexcept -> std::coroutine_handle<void>
+    {
+        return std::exchange(_handle, nullptr);
+    }
+
 public:
     /// @brief Gets the result from the promise of the referred coroutine.
     /// @note Errors out if this task doesn't refer a coroutine, or the task is not done yet.
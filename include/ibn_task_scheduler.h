@@ -0,0 +1,314 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include "ibn_task.h"
+#include "ibn_timer_wheel.h"
+
+#include <bn_assert.h>
+#include <bn_intrusive_list.h>
+
+#include <coroutine>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace ibn
+{
+
+/// @brief Resumes the spawned tasks once per frame, in the order of their priorities.
+///
+/// Each `update()` resumes every ready task once, from the highest priority (`0`) to the lowest,
+/// in the order they became ready within the same priority. \n
+/// A task that suspends is resumed again on the next `update()`, and a task that completes is destroyed.
+///
+/// Tasks can also wait with `co_await next_frame()`, `co_await frames(n)` and `co_await until(pred)`. \n
+/// Sleeping tasks are not touched until they wake up, and the waiting ones only have their predicates called,
+/// instead of being resumed on every frame. \n
+/// Sleeping tasks are kept in a `timer_wheel`, so they cost nothing per frame except when they wake up.
+///
+/// If a frame budget is set, the tasks of the priorities lower than `0` are deferred to the next `update()`
+/// once the budget is used up in the current one, and they're resumed first among their priority then.
+///
+/// A task it `co_await`s can suspend with the awaitables above, which are resumed directly. \n
+/// Otherwise (e.g. `std::suspend_always`), only the spawned coroutine itself can suspend.
+///
+/// All the storage is allocated in the constructor, so spawning, resuming and cancelling allocate nothing. \n
+/// (Coroutine frames are still allocated with the allocator of each task, when the coroutine is called.)
+class task_scheduler final
+{
+public:
+    /// @brief Identifier of a spawned task, which no longer refers to it after it completes or is cancelled.
+    class task_id final
+    {
+    public:
+        /// @brief Default constructor, which refers to no task.
+        constexpr task_id() = default;
+
+        constexpr bool operator==(const task_id&) const = default;
+
+    private:
+        friend class task_scheduler;
+
+        constexpr task_id(int index, std::uint16_t generation) : _index(std::int16_t(index)), _generation(generation)
+        {
+        }
+
+    private:
+        std::int16_t _index = -1;
+        std::uint16_t _generation = 0;
+    };
+
+private:
+    enum class slot_state : std::uint8_t
+    {
+        FREE,
+        READY,    // in `_ready_queues`
+        SLEEPING, // in `*_sleeping_slots`, until `wake_frame`
+        WAITING,  // in `_waiting_slots`, until `poll(poll_object)` returns `true`
+    };
+
+    struct slot final : public timer_wheel_node
+    {
+        // Spawned coroutine, which is destroyed with the slot
+        std::coroutine_handle<void> handle;
+        // Coroutine to resume, which is a nested one if it suspended with the awaitables
+        std::coroutine_handle<void> resume_point;
+
+        bool (*poll)(void*) = nullptr;
+        void* poll_object = nullptr;
+        unsigned wake_frame = 0;
+
+        std::uint16_t generation = 0;
+        std::uint8_t priority = 0;
+        slot_state state = slot_state::FREE;
+        bool cancelled = false;
+    };
+
+public:
+    /// @brief Awaiter of `next_frame()`.
+    class next_frame_awaiter
+    {
+    public:
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<void> handle) const noexcept
+        {
+            running_slot().resume_point = handle;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    /// @brief Awaiter of `frames()`.
+    class frames_awaiter
+    {
+    public:
+        explicit frames_awaiter(int frames_count) : _frames_count(frames_count)
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return _frames_count <= 0;
+        }
+
+        void await_suspend(std::coroutine_handle<void> handle) const noexcept
+        {
+            slot& slot_ = running_slot();
+            slot_.resume_point = handle;
+
+            // Next frame is the same as `next_frame()`
+            if (_frames_count > 1)
+            {
+                slot_.state = slot_state::SLEEPING;
+                slot_.wake_frame = current()->_frame + unsigned(_frames_count);
+            }
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        int _frames_count;
+    };
+
+    /// @brief Awaiter of `until()`.
+    template <typename Pred>
+    class until_awaiter
+    {
+    public:
+        explicit until_awaiter(Pred&& pred) : _pred(std::forward<Pred>(pred))
+        {
+        }
+
+        bool await_ready()
+        {
+            return _pred();
+        }
+
+        void await_suspend(std::coroutine_handle<void> handle) noexcept
+        {
+            slot& slot_ = running_slot();
+            slot_.resume_point = handle;
+            slot_.state = slot_state::WAITING;
+            slot_.poll = [](void* pred) -> bool { return (*static_cast<std::remove_reference_t<Pred>*>(pred))(); };
+            slot_.poll_object = const_cast<void*>(static_cast<const void*>(std::addressof(_pred)));
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+    private:
+        // Stays in the coroutine frame while waiting
+        Pred _pred;
+    };
+
+public:
+    /// @brief Constructor.
+    /// @param max_tasks Maximum number of tasks spawned at the same time.
+    /// @param priorities_count Number of priorities, where `0` is the highest and is never deferred.
+    task_scheduler(int max_tasks, int priorities_count = 4);
+
+    /// @brief Destructor, which destroys all the tasks not completed yet.
+    ~task_scheduler();
+
+    task_scheduler(const task_scheduler&) = delete;
+    auto operator=(const task_scheduler&) -> task_scheduler& = delete;
+
+public:
+    /// @brief Takes over the task, which is resumed from the next `update()`.
+    /// @param task_ Task to spawn. If it's already completed, it's just destroyed.
+    /// @param priority Priority of the task, where `0` is the highest.
+    /// @return Identifier of the spawned task.
+    template <bool LazyStart, typename Allocator>
+    auto spawn(task<void, LazyStart, Allocator>&& task_, int priority) -> task_id
+    {
+        BN_ASSERT(task_, "task is not valid");
+
+        return spawn_handle(task_.release(), priority);
+    }
+
+    /// @brief Destroys the task, without resuming it anymore.
+    /// @note If a task cancels itself, it's destroyed right after it suspends.
+    void cancel(task_id id);
+
+    /// @brief Checks if the task is spawned, and not completed nor cancelled yet.
+    bool contains(task_id id) const;
+
+    /// @brief Wakes up the tasks whose wait is over, and resumes the ready tasks once each until the budget is used up.
+    /// @note Call this once per frame, e.g. right before `bn::core::update()`.
+    void update();
+
+    /// @brief Gets the scheduler resuming the current task, or `nullptr` if none.
+    static auto current() -> task_scheduler*;
+
+public:
+    /// @brief Gets the maximum number of tasks spawned at the same time.
+    auto max_tasks() const -> int
+    {
+        return _max_tasks;
+    }
+
+    /// @brief Gets the number of tasks spawned, and not completed nor cancelled yet.
+    auto tasks_count() const -> int
+    {
+        return _max_tasks - _free_slots.size();
+    }
+
+    /// @brief Gets the number of priorities, where `0` is the highest.
+    auto priorities_count() const -> int
+    {
+        return _priorities_count;
+    }
+
+    /// @brief Gets the ticks of `bn::timer` that an `update()` can spend, before deferring the rest.
+    auto frame_budget_ticks() const -> int
+    {
+        return _frame_budget_ticks;
+    }
+
+    /// @brief Sets the ticks of `bn::timer` that an `update()` can spend, before deferring the rest.
+    /// @param ticks Ticks of `bn::timer` (e.g. `bn::timers::ticks_per_frame() / 4`), or `0` to disable the budget.
+    /// @note A task that is already resumed can't be stopped, so an `update()` can still run over the budget.
+    void set_frame_budget_ticks(int ticks);
+
+    /// @brief Gets the number of `update()` calls so far, which wraps around.
+    auto frame() const -> unsigned
+    {
+        return _frame;
+    }
+
+    /// @brief Gets the number of tasks that the last `update()` deferred to the next one.
+    auto last_deferred_count() const -> int
+    {
+        return _last_deferred_count;
+    }
+
+private:
+    auto spawn_handle(std::coroutine_handle<void> handle, int priority) -> task_id;
+
+    auto slot_of(task_id id) const -> slot*;
+    void resume(slot& slot_);
+    void free_slot(slot& slot_);
+
+    void wake_sleeping_slots();
+    void poll_waiting_slots();
+    void sleep(slot& slot_);
+    void make_ready(slot& slot_);
+    void unlink(slot& slot_);
+
+    // Slot of the task being resumed, which the awaitables must be `co_await`ed from
+    static auto running_slot() -> slot&;
+
+private:
+    slot* _slots;
+    bn::intrusive_list<slot>* _ready_queues;
+    bn::intrusive_list<slot> _free_slots;
+
+    timer_wheel<slot>* _sleeping_slots;
+    bn::intrusive_list<slot> _waiting_slots;
+
+    // Slot being resumed, which can't be destroyed until it suspends
+    slot* _running = nullptr;
+
+    const int _max_tasks;
+    const int _priorities_count;
+    unsigned _frame = 0;
+    int _frame_budget_ticks = 0;
+    int _last_deferred_count = 0;
+};
+
+/// @brief Suspends the task until the next `task_scheduler::update()`.
+/// @note This must be `co_await`ed from a task resumed by a `task_scheduler`.
+inline auto next_frame() -> task_scheduler::next_frame_awaiter
+{
+    return {};
+}
+
+/// @brief Suspends the task for the frames, without being resumed in between.
+/// @param frames_count Number of `task_scheduler::update()` calls to wait for. If it's `0` or less, it doesn't suspend.
+/// @note This must be `co_await`ed from a task resumed by a `task_scheduler`.
+inline auto frames(int frames_count) -> task_scheduler::frames_awaiter
+{
+    return task_scheduler::frames_awaiter(frames_count);
+}
+
+/// @brief Suspends the task until the predicate returns `true`, which is checked once per frame without resuming it.
+/// @param pred Predicate to check. If it returns `true` right away, it doesn't suspend.
+/// @note This must be `co_await`ed from a task resumed by a `task_scheduler`.
+template <typename Pred>
+auto until(Pred&& pred) -> task_scheduler::until_awaiter<Pred>
+{
+    return task_scheduler::until_awaiter<Pred>(std::forward<Pred>(pred));
+}
+
+} // namespace ibn
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#pragma once
+
+#include <bn_assert.h>
+#include <bn_intrusive_list.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ibn
+{
+
+/// @brief Node of a `timer_wheel`, which is in a bucket of the wheel until it expires or is removed.
+/// @note A node is still a `bn::intrusive_list_node_type`, so it can be in another `bn::intrusive_list` instead.
+class timer_wheel_node : public bn::intrusive_list_node_type
+{
+public:
+    /// @brief Gets the frame it expires on.
+    auto expiry() const -> unsigned
+    {
+        return _expiry;
+    }
+
+    /// @brief Checks if it's in a `timer_wheel`.
+    bool in_wheel() const
+    {
+        return _bucket >= 0;
+    }
+
+private:
+    template <typename Type, int SlotBits, int Levels>
+    friend class timer_wheel;
+
+    unsigned _expiry = 0;
+    std::int16_t _bucket = -1;
+};
+
+/// @brief Hierarchical timer wheel of the nodes, which expire on the frames they're added with.
+///
+/// Each level has `1 << SlotBits` buckets, and each bucket of a level covers as many frames as a whole level below it.
+/// \n
+/// A node is added to the bucket of the lowest level that covers its expiry, and as the frames go by,
+/// it's moved down a level at a time until it expires from the lowest level.
+///
+/// So, adding and removing a node is O(1), and advancing a frame costs O(expired nodes),
+/// plus moving each node down at most `Levels - 1` times during its wait.
+///
+/// Expiries further than the wheel covers (`1 << (SlotBits * Levels)` frames) are kept in the highest level,
+/// and checked again every time their bucket comes around.
+/// @tparam Type Node type, which must derive from `timer_wheel_node`.
+/// @tparam SlotBits Number of bits of the frames each level covers.
+/// @tparam Levels Number of levels.
+template <typename Type, int SlotBits = 6, int Levels = 4>
+class timer_wheel final
+{
+    static_assert(std::is_base_of_v<timer_wheel_node, Type>, "Type must derive from timer_wheel_node");
+    static_assert(SlotBits > 0 && Levels > 0 && SlotBits * Levels < 32, "Invalid wheel size");
+
+private:
+    static constexpr int SLOTS = 1 << SlotBits;
+    static constexpr unsigned SLOT_MASK = SLOTS - 1;
+
+public:
+    /// @brief Constructor.
+    /// @param now Current frame.
+    explicit timer_wheel(unsigned now = 0) : _now(now)
+    {
+    }
+
+    ~timer_wheel()
+    {
+        clear();
+    }
+
+    timer_wheel(const timer_wheel&) = delete;
+    auto operator=(const timer_wheel&) -> timer_wheel& = delete;
+
+public:
+    /// @brief Gets the current frame.
+    auto now() const -> unsigned
+    {
+        return _now;
+    }
+
+    /// @brief Gets the number of the nodes in the wheel.
+    auto size() const -> int
+    {
+        return _size;
+    }
+
+    /// @brief Checks if there's no node in the wheel.
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /// @brief Adds the node, which expires on the frame.
+    /// @param node Node to add, which must not be in any list.
+    /// @param expiry Frame to expire on, which must be after `now()`.
+    void add(Type& node, unsigned expiry)
+    {
+        BN_ASSERT(!node.in_wheel(), "Node is already in a wheel");
+        BN_ASSERT(int(expiry - _now) > 0, "Expiry must be after now: ", expiry, " <= ", _now);
+
+        node._expiry = expiry;
+        insert(node);
+        ++_size;
+    }
+
+    /// @brief Removes the node before it expires.
+    void remove(Type& node)
+    {
+        BN_ASSERT(node.in_wheel(), "Node is not in a wheel");
+
+        _buckets[node._bucket].erase(node);
+        node._bucket = -1;
+        --_size;
+    }
+
+    /// @brief Removes all the nodes.
+    void clear()
+    {
+        for (bn::intrusive_list<Type>& bucket : _buckets)
+        {
+            while (!bucket.empty())
+            {
+                bucket.front()._bucket = -1;
+                bucket.pop_front();
+            }
+        }
+
+        _size = 0;
+    }
+
+    /// @brief Advances to the next frame, and removes the nodes expiring on it.
+    /// @param on_expired Called with each expired node, which is already removed from the wheel.
+    template <typename OnExpired>
+    void advance(OnExpired&& on_expired)
+    {
+        ++_now;
+
+        // Move the nodes down from the higher level buckets that the new frame enters
+        for (int level = 1; level < Levels; ++level)
+        {
+            if (((_now >> (SlotBits * (level - 1))) & SLOT_MASK) != 0)
+                break;
+
+            cascade(level * SLOTS + int((_now >> (SlotBits * level)) & SLOT_MASK));
+        }
+
+        bn::intrusive_list<Type>& bucket = _buckets[_now & SLOT_MASK];
+        while (!bucket.empty())
+        {
+            Type& node = bucket.front();
+            bucket.pop_front();
+            node._bucket = -1;
+            --_size;
+
+            on_expired(node);
+        }
+    }
+
+private:
+    void insert(Type& node)
+    {
+        const unsigned delta = node._expiry - _now;
+
+        int level = 0;
+        while (level + 1 < Levels && delta >> (SlotBits * (level + 1)) != 0)
+            ++level;
+
+        // Too far to cover stays in the highest level, and is inserted again when its bucket comes around
+        const int bucket = level * SLOTS + int((node._expiry >> (SlotBits * level)) & SLOT_MASK);
+
+        node._bucket = std::int16_t(bucket);
+        _buckets[bucket].push_back(node);
+    }
+
+    void cascade(int bucket_index)
+    {
+        bn::intrusive_list<Type>& bucket = _buckets[bucket_index];
+
+        // Re-insert only the nodes in the bucket now (the same bucket can be chosen again)
+        for (int count = bucket.size(); count > 0; --count)
+        {
+            Type& node = bucket.front();
+            bucket.pop_front();
+            insert(node);
+        }
+    }
+
+private:
+    bn::intrusive_list<Type> _buckets[SLOTS * Levels];
+    unsigned _now;
+    int _size = 0;
+};
+
+} // namespace ibn
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "ibn_code_iwram.h"
 #include "ibn_enum_as_flags.h"
 #include "ibn_observer.h"
 
@@ -19,6 +20,16 @@
 #include <limits>
 #include <type_traits>
 
+#ifndef IBN_CFG_TRANSITIONS_IWRAM
+#define IBN_CFG_TRANSITIONS_IWRAM false
+#endif
+
+#if IBN_CFG_TRANSITIONS_IWRAM
+#define IBN_TRANSITIONS_CODE IBN_CODE_IWRAM_ARM
+#else
+#define IBN_TRANSITIONS_CODE
+#endif
+
 namespace ibn
 {
 
@@ -56,7 +67,7 @@ public:
 
 public:
     /// @brief Call this once per frame.
-    void update();
+    IBN_TRANSITIONS_CODE void update();
 
 public:
     /// @brief Helper function to set the alpha values for many effects once.
@@ -32,6 +32,12 @@ bit_stream_writer::bit_stream_writer(word_type* begin, size_type words_length, s
     reset_with(begin, words_length, logical_bytes_length);
 }
 
+bit_stream_writer::bit_stream_writer(bn::span<word_type> chunk_buffer, size_type logical_bytes_length,
+                                     bit_stream_sink& sink)
+{
+    reset_with(chunk_buffer, logical_bytes_length, sink);
+}
+
 auto bit_stream_writer::used_bytes() const -> size_type
 {
     return ceil_to_multiple_of<8>(used_bits()) >> 3;
@@ -55,6 +61,7 @@ void bit_stream_writer::reset()
     _words = decltype(_words)();
     _logical_total_bits = 0;
     _init_fail = true;
+    _sink = nullptr;
 
     restart();
 }
@@ -64,6 +71,18 @@ void bit_stream_writer::reset_with(bn::span<word_type> buffer, size_type logical
     _words = buffer;
     _logical_total_bits = 8 * logical_bytes_length;
     _init_fail = (!buffer.data() || buffer.size() == 0 || int(logical_bytes_length) > buffer.size_bytes());
+    _sink = nullptr;
+
+    restart();
+}
+
+void bit_stream_writer::reset_with(bn::span<word_type> chunk_buffer, size_type logical_bytes_length,
+                                   bit_stream_sink& sink)
+{
+    _words = chunk_buffer;
+    _logical_total_bits = 8 * logical_bytes_length;
+    _init_fail = (!chunk_buffer.data() || chunk_buffer.size() == 0);
+    _sink = &sink;
 
     restart();
 }
@@ -90,6 +109,13 @@ auto bit_stream_writer::flush_final() -> bit_stream_writer&
     if (_scratch_index > 0)
         do_flush_word_unchecked();
 
+    // Drain the remaining words of the chunk buffer
+    if (_sink && _words_index > 0)
+    {
+        _sink->consume(bn::span<const word_type>(_words.data(), _words_index));
+        _words_index = 0;
+    }
+
     _final_flushed = true;
 
     return *this;
@@ -132,6 +158,13 @@ void bit_stream_writer::do_flush_word_unchecked()
     // Flush the word.
     _words[_words_index++] = word;
 
+    // Drain the chunk buffer if it's full.
+    if (_sink && _words_index == _words.size())
+    {
+        _sink->consume(bn::span<const word_type>(_words.data(), _words_index));
+        _words_index = 0;
+    }
+
     // Remove the flushed scratch data.
     _scratch >>= (8 * sizeof(word_type));
 
@@ -164,6 +197,12 @@ bit_stream_reader::bit_stream_reader(const word_type* begin, size_type words_len
     reset_with(begin, words_length, logical_bytes_length);
 }
 
+bit_stream_reader::bit_stream_reader(bn::span<word_type> chunk_buffer, size_type logical_bytes_length,
+                                     bit_stream_source& source)
+{
+    reset_with(chunk_buffer, logical_bytes_length, source);
+}
+
 auto bit_stream_reader::used_bytes() const -> size_type
 {
     return ceil_to_multiple_of<8>(used_bits()) >> 3;
@@ -175,9 +214,13 @@ void bit_stream_reader::restart()
 
     _scratch_bits = 0;
     _words_index = 0;
+    _words_base = 0;
 
     _logical_used_bits = 0;
     _fail = _init_fail;
+
+    if (_source && !_fail)
+        fetch_chunk(0);
 }
 
 void bit_stream_reader::reset()
@@ -185,6 +228,7 @@ void bit_stream_reader::reset()
     _words = decltype(_words)();
     _logical_total_bits = 0;
     _init_fail = true;
+    _source = nullptr;
 
     restart();
 }
@@ -194,6 +238,18 @@ void bit_stream_reader::reset_with(bn::span<const word_type> buffer, size_type l
     _words = buffer;
     _logical_total_bits = 8 * logical_bytes_length;
     _init_fail = (!buffer.data() || buffer.size() == 0 || int(logical_bytes_length) > buffer.size_bytes());
+    _source = nullptr;
+
+    restart();
+}
+
+void bit_stream_reader::reset_with(bn::span<word_type> chunk_buffer, size_type logical_bytes_length,
+                                   bit_stream_source& source)
+{
+    _words = chunk_buffer;
+    _logical_total_bits = 8 * logical_bytes_length;
+    _init_fail = (!chunk_buffer.data() || chunk_buffer.size() == 0);
+    _source = &source;
 
     restart();
 }
@@ -234,6 +290,7 @@ auto bit_stream_reader::peek_string_length() -> ssize_type
     const auto prev_scratch = _scratch;
     const auto prev_scratch_bits = _scratch_bits;
     const auto prev_words_index = _words_index;
+    const auto prev_words_base = _words_base;
     const auto prev_logical_used_bits = _logical_used_bits;
 
     // Read string length
@@ -242,12 +299,65 @@ auto bit_stream_reader::peek_string_length() -> ssize_type
     // Restore previous stream states
     _scratch = prev_scratch;
     _scratch_bits = prev_scratch_bits;
-    _words_index = prev_words_index;
     _logical_used_bits = prev_logical_used_bits;
 
+    // Fetch the previous chunk again, if it has been moved on
+    if (_source && _words_base != prev_words_base)
+        fetch_chunk(prev_words_base);
+    _words_index = prev_words_index;
+
     return result;
 }
 
+auto bit_stream_reader::skip(size_type bits) -> bit_stream_reader&
+{
+    IBN_BIT_STREAM_RETURN_IF_STREAM_ALREADY_FAILED(*this);
+
+    // Overflow check, which must not wrap around with a huge `bits` (e.g. a corrupt section length).
+    if (bits > _logical_total_bits - _logical_used_bits)
+    {
+        _fail = true;
+        return *this;
+    }
+
+    if (bits <= static_cast<size_type>(_scratch_bits))
+    {
+        // Skipped bits are all in `_scratch`, just remove them.
+        _scratch >>= bits;
+        _scratch_bits -= bits;
+    }
+    else
+    {
+        // Jump to the word containing the target bit, and drop the scratch.
+        const size_type target_bits = _logical_used_bits + bits;
+        constexpr size_type WORD_BITS = 8 * sizeof(word_type);
+
+        _scratch = 0;
+        _scratch_bits = 0;
+
+        const size_type target_word_index = target_bits / WORD_BITS;
+        if (!_source)
+            _words_index = static_cast<int>(target_word_index);
+        else if (target_word_index >= _words_base && target_word_index - _words_base < size_type(_words.size()))
+            _words_index = static_cast<int>(target_word_index - _words_base);
+        else
+            fetch_chunk(target_word_index);
+
+        // Load the word and remove the bits before the target bit.
+        const int remainder_bits = static_cast<int>(target_bits % WORD_BITS);
+        if (remainder_bits > 0)
+        {
+            do_fetch_word_unchecked();
+            _scratch >>= remainder_bits;
+            _scratch_bits -= remainder_bits;
+        }
+    }
+
+    _logical_used_bits += bits;
+
+    return *this;
+}
+
 auto bit_stream_reader::read_string_length() -> ssize_type
 {
     ssize_type result = -1;
@@ -296,6 +406,10 @@ auto bit_stream_reader::read_string_length() -> ssize_type
 
 void bit_stream_reader::do_fetch_word_unchecked()
 {
+    // Fetch the next chunk if the chunk buffer is exhausted.
+    if (_source && _words_index == _words.size())
+        fetch_chunk(_words_base + _words_index);
+
     // Get the word to load to scratch.
     word_type word = _words[_words_index++];
     if constexpr (std::endian::native == std::endian::big)
@@ -308,4 +422,14 @@ void bit_stream_reader::do_fetch_word_unchecked()
     _scratch_bits += 8 * sizeof(word_type);
 }
 
+void bit_stream_reader::fetch_chunk(size_type first_word_index)
+{
+    // `_words` is a const view of the chunk buffer, which was passed as mutable.
+    bn::span<word_type> chunk(const_cast<word_type*>(_words.data()), _words.size());
+    _source->fetch(first_word_index, chunk);
+
+    _words_base = first_word_index;
+    _words_index = 0;
+}
+
 } // namespace ibn
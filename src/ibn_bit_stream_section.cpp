@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_bit_stream_section.h"
+
+namespace ibn
+{
+
+bool read_section_header(bit_stream_reader& reader, bit_stream_section_header& header)
+{
+    return reader.read(header.id).read(header.version).read(header.bits).operator bool();
+}
+
+bool skip_section(bit_stream_reader& reader, const bit_stream_section_header& header)
+{
+    return reader.skip(header.bits).operator bool();
+}
+
+} // namespace ibn
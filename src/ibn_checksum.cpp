@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_checksum.h"
+
+#include "ibn_crc32.h"
+
+#include <bn_assert.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace ibn
+{
+
+namespace
+{
+
+constexpr std::uint32_t FLETCHER32_MODULO = 65535;
+constexpr std::uint32_t ADLER32_MODULO = 65521;
+
+// Max number of words or bytes that the sums can't overflow before the modulo
+constexpr std::size_t FLETCHER32_MAX_WORDS = 359;
+constexpr std::size_t ADLER32_MAX_BYTES = 5552;
+
+constexpr std::uint32_t XXHASH32_PRIME_1 = 2654435761u;
+constexpr std::uint32_t XXHASH32_PRIME_2 = 2246822519u;
+constexpr std::uint32_t XXHASH32_PRIME_3 = 3266489917u;
+constexpr std::uint32_t XXHASH32_PRIME_4 = 668265263u;
+constexpr std::uint32_t XXHASH32_PRIME_5 = 374761393u;
+constexpr std::size_t XXHASH32_STRIPE_SIZE = 16;
+
+auto read_u32(const std::uint8_t* bytes) -> std::uint32_t
+{
+    return std::uint32_t(bytes[0]) | (std::uint32_t(bytes[1]) << 8) | (std::uint32_t(bytes[2]) << 16) |
+           (std::uint32_t(bytes[3]) << 24);
+}
+
+auto xxhash32_round(std::uint32_t acc, std::uint32_t lane) -> std::uint32_t
+{
+    return std::rotl(acc + lane * XXHASH32_PRIME_2, 13) * XXHASH32_PRIME_1;
+}
+
+void xxhash32_stripe(std::uint32_t (&accs)[4], const std::uint8_t* stripe)
+{
+    for (int lane = 0; lane < 4; ++lane)
+        accs[lane] = xxhash32_round(accs[lane], read_u32(stripe + lane * 4));
+}
+
+} // namespace
+
+checksum_stream::checksum_stream(checksum_kind kind) : _kind(kind)
+{
+    switch (kind)
+    {
+    case checksum_kind::CRC32:
+    case checksum_kind::FLETCHER32:
+        _state[0] = 0;
+        _state[1] = 0;
+        break;
+    case checksum_kind::ADLER32:
+        _state[0] = 1;
+        _state[1] = 0;
+        break;
+    case checksum_kind::XXHASH32:
+        _state[0] = XXHASH32_PRIME_1 + XXHASH32_PRIME_2;
+        _state[1] = XXHASH32_PRIME_2;
+        _state[2] = 0;
+        _state[3] = 0 - XXHASH32_PRIME_1;
+        break;
+    default:
+        BN_ERROR("Invalid checksum kind: ", int(kind));
+    }
+}
+
+auto checksum_stream::crc32(std::uint32_t previous_crc32) -> checksum_stream
+{
+    checksum_stream result(checksum_kind::CRC32);
+    result._state[0] = previous_crc32;
+    return result;
+}
+
+auto checksum_stream::update(const void* data, std::size_t length) -> checksum_stream&
+{
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+
+    switch (_kind)
+    {
+    case checksum_kind::CRC32:
+        _state[0] = crc32_fast(bytes, length, _state[0]);
+        break;
+    case checksum_kind::FLETCHER32:
+        update_fletcher32(bytes, length);
+        break;
+    case checksum_kind::ADLER32:
+        update_adler32(bytes, length);
+        break;
+    case checksum_kind::XXHASH32:
+        update_xxhash32(bytes, length);
+        break;
+    default:
+        break;
+    }
+
+    _length += length;
+    return *this;
+}
+
+auto checksum_stream::value() const -> std::uint32_t
+{
+    switch (_kind)
+    {
+    case checksum_kind::CRC32:
+        return _state[0];
+
+    case checksum_kind::FLETCHER32: {
+        // Odd byte is padded with zero
+        std::uint32_t sum_1 = _state[0];
+        std::uint32_t sum_2 = _state[1];
+        if (_pending_size != 0)
+        {
+            sum_1 = (sum_1 + _pending[0]) % FLETCHER32_MODULO;
+            sum_2 = (sum_2 + sum_1) % FLETCHER32_MODULO;
+        }
+        return (sum_2 << 16) | sum_1;
+    }
+
+    case checksum_kind::ADLER32:
+        return (_state[1] << 16) | _state[0];
+
+    case checksum_kind::XXHASH32: {
+        std::uint32_t hash;
+        if (_length >= XXHASH32_STRIPE_SIZE)
+            hash = std::rotl(_state[0], 1) + std::rotl(_state[1], 7) + std::rotl(_state[2], 12) +
+                   std::rotl(_state[3], 18);
+        else
+            hash = XXHASH32_PRIME_5;
+
+        hash += _length;
+
+        int offset = 0;
+        for (; offset + 4 <= _pending_size; offset += 4)
+            hash = std::rotl(hash + read_u32(_pending + offset) * XXHASH32_PRIME_3, 17) * XXHASH32_PRIME_4;
+        for (; offset < _pending_size; ++offset)
+            hash = std::rotl(hash + _pending[offset] * XXHASH32_PRIME_5, 11) * XXHASH32_PRIME_1;
+
+        hash ^= hash >> 15;
+        hash *= XXHASH32_PRIME_2;
+        hash ^= hash >> 13;
+        hash *= XXHASH32_PRIME_3;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+void checksum_stream::update_fletcher32(const std::uint8_t* bytes, std::size_t length)
+{
+    std::uint32_t sum_1 = _state[0];
+    std::uint32_t sum_2 = _state[1];
+
+    // Complete the word with the odd byte of the previous chunk
+    if (_pending_size != 0 && length != 0)
+    {
+        sum_1 = (sum_1 + (_pending[0] | (std::uint32_t(*bytes++) << 8))) % FLETCHER32_MODULO;
+        sum_2 = (sum_2 + sum_1) % FLETCHER32_MODULO;
+        _pending_size = 0;
+        --length;
+    }
+
+    while (length >= 2)
+    {
+        const std::size_t words = std::min(length / 2, FLETCHER32_MAX_WORDS);
+        for (std::size_t word = 0; word < words; ++word, bytes += 2)
+        {
+            sum_1 += bytes[0] | (std::uint32_t(bytes[1]) << 8);
+            sum_2 += sum_1;
+        }
+
+        sum_1 %= FLETCHER32_MODULO;
+        sum_2 %= FLETCHER32_MODULO;
+        length -= words * 2;
+    }
+
+    if (length != 0)
+    {
+        _pending[0] = *bytes;
+        _pending_size = 1;
+    }
+
+    _state[0] = sum_1;
+    _state[1] = sum_2;
+}
+
+void checksum_stream::update_adler32(const std::uint8_t* bytes, std::size_t length)
+{
+    std::uint32_t sum_1 = _state[0];
+    std::uint32_t sum_2 = _state[1];
+
+    while (length != 0)
+    {
+        const std::size_t count = std::min(length, ADLER32_MAX_BYTES);
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            sum_1 += bytes[index];
+            sum_2 += sum_1;
+        }
+
+        sum_1 %= ADLER32_MODULO;
+        sum_2 %= ADLER32_MODULO;
+        bytes += count;
+        length -= count;
+    }
+
+    _state[0] = sum_1;
+    _state[1] = sum_2;
+}
+
+void checksum_stream::update_xxhash32(const std::uint8_t* bytes, std::size_t length)
+{
+    // Complete the partial stripe of the previous chunks
+    if (_pending_size != 0)
+    {
+        const std::size_t count = std::min(length, XXHASH32_STRIPE_SIZE - _pending_size);
+        std::copy(bytes, bytes + count, _pending + _pending_size);
+        _pending_size += count;
+        bytes += count;
+        length -= count;
+
+        if (_pending_size < XXHASH32_STRIPE_SIZE)
+            return;
+
+        xxhash32_stripe(_state, _pending);
+        _pending_size = 0;
+    }
+
+    for (; length >= XXHASH32_STRIPE_SIZE; bytes += XXHASH32_STRIPE_SIZE, length -= XXHASH32_STRIPE_SIZE)
+        xxhash32_stripe(_state, bytes);
+
+    std::copy(bytes, bytes + length, _pending);
+    _pending_size = length;
+}
+
+} // namespace ibn
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_sram_journal.h"
+
+#include <bn_cstring.h>
+
+namespace ibn
+{
+
+sram_journal::sram_journal(bn::string_view magic, unsigned snapshot_location_0, unsigned snapshot_location_1,
+                           unsigned journal_location, unsigned journal_size, storage& storage_)
+    : _storage(&storage_), _snapshot_rw(magic, snapshot_location_0, snapshot_location_1, storage_),
+      _journal_location(journal_location), _journal_size(journal_size)
+{
+    BN_ASSERT(journal_location + journal_size <= unsigned(storage_.size()), "Invalid journal region: ",
+              journal_location, " + ", journal_size);
+    BN_ASSERT(journal_location % sizeof(bit_stream_writer::word_type) == 0,
+              "Journal location not aligned to bit stream words: ", journal_location);
+    BN_ASSERT(journal_location % storage_.erase_block_size() == 0 && journal_size % storage_.erase_block_size() == 0,
+              "Journal region not aligned to erase blocks: ", journal_location, " + ", journal_size);
+}
+
+auto sram_journal::record_size(unsigned payload_size) -> unsigned
+{
+    return sizeof(record_header) + ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(payload_size);
+}
+
+auto sram_journal::journal_head_generation() const -> std::uint16_t
+{
+    if (_journal_size < sizeof(record_header))
+        return 0;
+
+    record_header header;
+    _storage->read(_journal_location, bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&header), sizeof(header)));
+    return header.generation;
+}
+
+bool sram_journal::read_record(bit_stream_writer::word_type* buffer, bit_stream_reader::size_type& payload_size) const
+{
+    if (_journal_used + sizeof(record_header) > _journal_size)
+        return false;
+
+    // Read & validate the header
+    record_header header;
+    _storage->read(_journal_location + _journal_used,
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&header), sizeof(header)));
+
+    if (header.generation != _generation || header.payload_size > MAX_RECORD_SIZE ||
+        _journal_used + record_size(header.payload_size) > _journal_size)
+        return false;
+
+    // Read the payload
+    const unsigned size = record_size(header.payload_size);
+    bn::memcpy(buffer, &header, sizeof(record_header));
+    _storage->read(_journal_location + _journal_used + sizeof(record_header),
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(buffer + HEADER_WORDS),
+                                          size - sizeof(record_header)));
+
+    // Validate crc32 checksum
+    const auto* crc32_data = reinterpret_cast<const std::uint8_t*>(buffer) + sizeof(std::uint32_t);
+    if (crc32_fast(crc32_data, size - sizeof(std::uint32_t)) != header.crc32)
+        return false;
+
+    payload_size = header.payload_size;
+    return true;
+}
+
+void sram_journal::write_record(bit_stream_writer::word_type* buffer, unsigned payload_size)
+{
+    const unsigned size = record_size(payload_size);
+
+    // Write the header
+    record_header header;
+    header.generation = _generation;
+    header.payload_size = payload_size;
+    bn::memcpy(buffer, &header, sizeof(record_header));
+
+    // Write crc32 checksum
+    auto* crc32_data = reinterpret_cast<std::uint8_t*>(buffer) + sizeof(std::uint32_t);
+    header.crc32 = crc32_fast(crc32_data, size - sizeof(std::uint32_t));
+    bn::memcpy(buffer, &header.crc32, sizeof(std::uint32_t));
+
+    // Store to the storage
+    _storage->write(_journal_location + _journal_used,
+                    bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(buffer), size));
+
+    _journal_used += size;
+}
+
+bool sram_journal::tail_writable() const
+{
+    if (_storage->erase_block_size() == 1 || _journal_used + sizeof(record_header) > _journal_size)
+        return true;
+
+    // Any byte written in the header of the next record means a torn record
+    std::uint8_t header_bytes[sizeof(record_header)];
+    _storage->read(_journal_location + _journal_used, header_bytes);
+    for (const std::uint8_t byte : header_bytes)
+        if (byte != 0xFF)
+            return false;
+
+    return true;
+}
+
+void sram_journal::erase_journal()
+{
+    // Records of the previous generations are ignored anyway, so SRAM is left as is
+    if (_storage->erase_block_size() > 1 && _journal_size > 0)
+        _storage->erase(_journal_location, _journal_size);
+}
+
+} // namespace ibn
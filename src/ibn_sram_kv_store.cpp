@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_sram_kv_store.h"
+
+#include "ibn_crc32.h"
+#include "ibn_sequence_greater_than.h"
+
+#include <bn_cstring.h>
+
+namespace ibn
+{
+
+sram_kv_store::sram_kv_store(bn::string_view magic, unsigned location, bn::span<const std::uint16_t> max_value_sizes,
+                             storage& storage_)
+    : _storage(&storage_), _location(location)
+{
+    BN_ASSERT(storage_.erase_block_size() == 1, "Storage needs erasing: ", storage_.erase_block_size());
+    // Allow ending with '\n' case with `MAGIC_LEN + 1` for convenience
+    BN_ASSERT(magic.size() == MAGIC_LEN || magic.size() == MAGIC_LEN + 1, "Invalid magic length: ", magic.size(),
+              " (must be ", MAGIC_LEN, ")");
+    BN_ASSERT(max_value_sizes.size() <= int(MAX_KEYS), "Too many keys: ", max_value_sizes.size(), " (max ", MAX_KEYS,
+              ")");
+    BN_ASSERT(location % sizeof(bit_stream_writer::word_type) == 0,
+              "Location not aligned to bit stream words: ", location);
+
+    _magic_crc32 = crc32_fast(magic.data(), MAGIC_LEN);
+
+    // Lay out two slots for each key
+    unsigned slot_location = location;
+    _keys_count = max_value_sizes.size();
+    for (unsigned key = 0; key < _keys_count; ++key)
+    {
+        const unsigned max_value_size = max_value_sizes[key];
+        BN_ASSERT(max_value_size <= MAX_VALUE_SIZE, "Max value size too big: ", max_value_size, " (key ", key, ")");
+
+        entry& entry_ = _entries[key];
+        entry_.location = slot_location;
+        entry_.max_value_size = max_value_size;
+        entry_.value_size = 0;
+        entry_.sequence = 0;
+        entry_.current_slot = -1;
+        entry_.erased = false;
+
+        slot_location += 2 * slot_size(max_value_size);
+    }
+
+    _size_bytes = slot_location - location;
+    BN_ASSERT(slot_location <= unsigned(storage_.size()), "Store too big: ", _size_bytes, " bytes at ", location);
+
+    build_index();
+}
+
+void sram_kv_store::erase(key_type key)
+{
+    BN_ASSERT(key < _keys_count, "Invalid key: ", key);
+
+    if (!contains(key))
+        return;
+
+    bit_stream_writer::word_type buffer[HEADER_WORDS];
+    write_slot(key, buffer, TOMBSTONE);
+}
+
+auto sram_kv_store::slot_size(unsigned max_value_size) -> unsigned
+{
+    return sizeof(slot_header) + ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(max_value_size);
+}
+
+void sram_kv_store::build_index()
+{
+    bit_stream_writer::word_type buffer[SLOT_BUFFER_WORDS];
+
+    for (unsigned key = 0; key < _keys_count; ++key)
+    {
+        entry& entry_ = _entries[key];
+
+        // Pick the recent valid slot
+        for (int slot = 0; slot < 2; ++slot)
+        {
+            slot_header header;
+            if (!load_slot(key, slot, buffer, header))
+                continue;
+
+            if (entry_.current_slot < 0 || sequence_greater_than(header.sequence, entry_.sequence))
+            {
+                entry_.current_slot = slot;
+                entry_.sequence = header.sequence;
+                entry_.erased = (header.value_size == TOMBSTONE);
+                entry_.value_size = entry_.erased ? 0 : header.value_size;
+            }
+        }
+    }
+}
+
+bool sram_kv_store::load_slot(key_type key, int slot, bit_stream_writer::word_type* buffer, slot_header& header) const
+{
+    const entry& entry_ = _entries[key];
+    const unsigned location = entry_.location + slot * slot_size(entry_.max_value_size);
+
+    // Read & validate the header
+    _storage->read(location, bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&header), sizeof(header)));
+    if (header.key != key || (header.value_size > entry_.max_value_size && header.value_size != TOMBSTONE))
+        return false;
+
+    // Read the value
+    const unsigned value_size = (header.value_size == TOMBSTONE) ? 0 : header.value_size;
+    const unsigned ceiled_value_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(value_size);
+    bn::memcpy(buffer, &header, sizeof(slot_header));
+    _storage->read(location + sizeof(slot_header),
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(buffer + HEADER_WORDS), ceiled_value_size));
+
+    // Validate crc32 checksum
+    return slot_crc32(buffer, value_size) == header.crc32;
+}
+
+bool sram_kv_store::read_slot(key_type key, bit_stream_reader::word_type* value_buffer) const
+{
+    BN_ASSERT(key < _keys_count, "Invalid key: ", key);
+
+    const entry& entry_ = _entries[key];
+    if (entry_.current_slot < 0 || entry_.erased)
+        return false;
+
+    // Already validated on building the index
+    const unsigned location = entry_.location + entry_.current_slot * slot_size(entry_.max_value_size);
+    const unsigned ceiled_value_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(entry_.value_size);
+    _storage->read(location + sizeof(slot_header),
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(value_buffer), ceiled_value_size));
+
+    return true;
+}
+
+void sram_kv_store::write_slot(key_type key, bit_stream_writer::word_type* buffer, unsigned value_size)
+{
+    entry& entry_ = _entries[key];
+
+    // Write to the other slot
+    const int slot = (entry_.current_slot == 0) ? 1 : 0;
+    const std::uint8_t sequence = (entry_.current_slot < 0) ? 0 : std::uint8_t(entry_.sequence + 1);
+    const unsigned location = entry_.location + slot * slot_size(entry_.max_value_size);
+
+    // Prepare the header
+    slot_header header;
+    header.crc32 = 0;
+    header.key = key;
+    header.sequence = sequence;
+    header.value_size = value_size;
+    bn::memcpy(buffer, &header, sizeof(slot_header));
+
+    const bool erased = (value_size == TOMBSTONE);
+    const unsigned stored_value_size = erased ? 0 : value_size;
+    header.crc32 = slot_crc32(buffer, stored_value_size);
+
+    // Write the value first, and the header last
+    const unsigned ceiled_value_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(stored_value_size);
+    _storage->write(location + sizeof(slot_header),
+                    bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(buffer + HEADER_WORDS),
+                                                 ceiled_value_size));
+    _storage->write(location,
+                    bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)));
+
+    entry_.current_slot = slot;
+    entry_.sequence = sequence;
+    entry_.value_size = stored_value_size;
+    entry_.erased = erased;
+}
+
+auto sram_kv_store::slot_crc32(const bit_stream_writer::word_type* buffer, unsigned value_size) const -> std::uint32_t
+{
+    const auto* crc32_data = reinterpret_cast<const std::uint8_t*>(buffer) + sizeof(std::uint32_t);
+    const unsigned ceiled_value_size = ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(value_size);
+    return crc32_fast(crc32_data, sizeof(slot_header) - sizeof(std::uint32_t) + ceiled_value_size, _magic_crc32);
+}
+
+} // namespace ibn
@@ -4,52 +4,298 @@
 #include "ibn_sram_rw.h"
 
 #include <algorithm>
-#include <limits>
 
 namespace ibn
 {
 
-sram_rw::sram_rw(bn::span<const std::uint8_t> magic, unsigned location_0, unsigned location_1)
-    : _location_0(location_0), _location_1(location_1)
+sram_rw::sram_rw(bn::span<const std::uint8_t> magic, unsigned location_0, unsigned location_1, storage& storage_,
+                 checksum_kind checksum)
+    : _storage(&storage_), _location_0(location_0), _location_1(location_1), _checksum_kind(checksum)
 {
+    BN_ASSERT(checksum < checksum_kind::COUNT, "Invalid checksum: ", int(checksum));
     BN_ASSERT(magic.size() == MAGIC_LEN, "Invalid magic length: ", magic.size(), " (must be ", MAGIC_LEN, ")");
 
-    BN_ASSERT(location_0 < SRAM_SIZE - sizeof(header), "Invalid location_0: ", location_0);
-    BN_ASSERT(location_1 < SRAM_SIZE - sizeof(header), "Invalid location_1: ", location_1);
+    ensure_valid_locations();
 
     bn::memcpy(_magic, magic.data(), sizeof(_magic));
 }
 
-sram_rw::sram_rw(bn::string_view magic, unsigned location_0, unsigned location_1)
-    : _location_0(location_0), _location_1(location_1)
+sram_rw::sram_rw(bn::string_view magic, unsigned location_0, unsigned location_1, storage& storage_,
+                 checksum_kind checksum)
+    : _storage(&storage_), _location_0(location_0), _location_1(location_1), _checksum_kind(checksum)
 {
+    BN_ASSERT(checksum < checksum_kind::COUNT, "Invalid checksum: ", int(checksum));
     // Allow ending with '\n' case with `MAGIC_LEN + 1` for convenience
     BN_ASSERT(magic.size() == MAGIC_LEN || magic.size() == MAGIC_LEN + 1, "Invalid magic length: ", magic.size(),
               " (must be ", MAGIC_LEN, ")");
 
-    BN_ASSERT(location_0 < SRAM_SIZE - sizeof(header), "Invalid location_0: ", location_0);
-    BN_ASSERT(location_1 < SRAM_SIZE - sizeof(header), "Invalid location_1: ", location_1);
+    ensure_valid_locations();
 
     bn::memcpy(_magic, magic.data(), sizeof(_magic));
 }
 
+sram_rw::~sram_rw()
+{
+    delete[] _pending_buffer;
+    delete[] _block_crc32s;
+}
+
+void sram_rw::update(unsigned max_bytes)
+{
+    if (done())
+        return;
+
+    BN_ASSERT(max_bytes > 0, "Invalid max_bytes: ", max_bytes);
+
+    IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+
+    // Erase the location first, which is the slowest part on a Flash
+    if (!_pending_erased)
+    {
+        _pending_erased = true;
+        if (erase_location(_pending_location, _pending_size))
+            return;
+    }
+
+    // Write the data portion first
+    const unsigned data_size = _pending_size - sizeof(header);
+    if (_pending_written < data_size)
+    {
+        const unsigned bytes = std::min(max_bytes, data_size - _pending_written);
+        const unsigned offset = sizeof(header) + _pending_written;
+
+        _storage->write(_pending_location + offset, bn::span<const std::uint8_t>(_pending_buffer + offset, bytes));
+        _pending_written += bytes;
+
+        if (_pending_written < data_size)
+            return;
+    }
+
+    // Write the header last, which makes this location valid
+    _storage->write(_pending_location, bn::span<const std::uint8_t>(_pending_buffer, sizeof(header)));
+    commit_next_location(*reinterpret_cast<const header*>(_pending_buffer));
+
+    delete[] _pending_buffer;
+    _pending_buffer = nullptr;
+}
+
+sram_rw::sram_sink::sram_sink(storage& storage_, int location, const checksum_stream& checksum)
+    : _storage(&storage_), _location(location), _checksum(checksum)
+{
+}
+
+void sram_rw::sram_sink::consume(bn::span<const bit_stream_writer::word_type> words)
+{
+    bn::span<const std::uint8_t> bytes(reinterpret_cast<const std::uint8_t*>(words.data()), words.size_bytes());
+
+    {
+        IBN_STATS_SRAM_RW_PHASE(CHECKSUM);
+        _checksum.update(bytes);
+    }
+    {
+        IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+        _storage->write(_location, bytes);
+    }
+
+    _location += bytes.size_bytes();
+}
+
+sram_rw::sram_source::sram_source(storage& storage_, int location, unsigned words_count)
+    : _storage(&storage_), _location(location), _words_count(words_count)
+{
+}
+
+void sram_rw::sram_source::fetch(bit_stream_reader::size_type first_word_index,
+                                 bn::span<bit_stream_reader::word_type> words)
+{
+    if (unsigned(first_word_index) >= _words_count)
+        return;
+
+    const unsigned count = std::min(unsigned(words.size()), _words_count - unsigned(first_word_index));
+    _storage->read(_location + first_word_index * sizeof(bit_stream_reader::word_type),
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(words.data()),
+                                          count * sizeof(bit_stream_reader::word_type)));
+}
+
+sram_rw::incremental_sram_sink::incremental_sram_sink(storage& storage_, int location,
+                                                     const checksum_stream& checksum, std::uint32_t* block_crc32s,
+                                                     unsigned prev_blocks_count)
+    : _storage(&storage_), _location(location), _checksum(checksum), _block_crc32s(block_crc32s),
+      _prev_blocks_count(prev_blocks_count)
+{
+}
+
+void sram_rw::incremental_sram_sink::consume(bn::span<const bit_stream_writer::word_type> words)
+{
+    bn::span<const std::uint8_t> bytes(reinterpret_cast<const std::uint8_t*>(words.data()), words.size_bytes());
+
+    std::uint32_t block_crc32;
+    {
+        IBN_STATS_SRAM_RW_PHASE(CHECKSUM);
+        block_crc32 = crc32_fast(bytes.data(), bytes.size_bytes());
+
+        // The whole crc32 is combined from the block crc32, instead of calculating it from the bytes again
+        // (except for the last partial block, which is cheaper to calculate again than to combine with any length)
+        if (_checksum.kind() == checksum_kind::CRC32 && bytes.size_bytes() == BLOCK_SIZE)
+            _checksum = checksum_stream::crc32(BLOCK_COMBINER.combine(_checksum.value(), block_crc32));
+        else
+            _checksum.update(bytes);
+    }
+
+    // Write the block only if it has been changed
+    if (_blocks_count >= _prev_blocks_count || _block_crc32s[_blocks_count] != block_crc32)
+    {
+        IBN_STATS_SRAM_RW_PHASE(STORAGE_WRITE);
+        _storage->write(_location, bytes);
+        _written_bytes += bytes.size_bytes();
+    }
+
+    _block_crc32s[_blocks_count++] = block_crc32;
+    _location += bytes.size_bytes();
+}
+
+bool sram_rw::scan()
+{
+    // Validate the locations not known yet
+    for (int index = 0; index < 2; ++index)
+    {
+        if (_location_states[index] != location_state::UNKNOWN)
+            continue;
+
+        const int location = location_of(index);
+        const header header_ = read_header_at(location);
+
+        if (validate_header(header_) && validate_checksum_at(location, header_))
+        {
+            _location_states[index] = location_state::VALID;
+            _cached_headers[index] = header_;
+        }
+        else
+        {
+            _location_states[index] = location_state::INVALID;
+        }
+    }
+
+    const int recent_index = recent_valid_index();
+    if (recent_index < 0)
+        return false;
+
+    _next_sequence = _cached_headers[recent_index].sequence + 1;
+    return true;
+}
+
+bool sram_rw::resume_sequence()
+{
+    return scan();
+}
+
+bool sram_rw::has_save()
+{
+    return scan();
+}
+
+auto sram_rw::saved_data_size() -> unsigned
+{
+    if (!scan())
+        return 0;
+
+    return _cached_headers[recent_valid_index()].data_size;
+}
+
+auto sram_rw::saved_schema_hash() -> std::uint32_t
+{
+    if (!scan())
+        return 0;
+
+    return _cached_headers[recent_valid_index()].schema_hash;
+}
+
+bool sram_rw::validate_checksum_at(int location, const header& header_) const
+{
+    const unsigned data_location = location + header_size(header_);
+    const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header_.data_size);
+
+    if (data_location + ceiled_data_size > unsigned(_storage->size()))
+        return false;
+
+    checksum_stream checksum = header_checksum(header_);
+
+    // Read the data chunk by chunk
+    bit_stream_reader::word_type chunk[STREAM_CHUNK_WORDS];
+    for (unsigned offset = 0; offset < ceiled_data_size; offset += sizeof(chunk))
+    {
+        const unsigned chunk_size = std::min(unsigned(sizeof(chunk)), ceiled_data_size - offset);
+        bn::span<std::uint8_t> chunk_span(reinterpret_cast<std::uint8_t*>(chunk), chunk_size);
+        _storage->read(data_location + offset, chunk_span);
+
+        checksum.update(chunk_span);
+    }
+
+    return checksum.value() == header_.checksum;
+}
+
 auto sram_rw::read_header_at(const int location) -> header
 {
     header result;
-    bn::sram::read_offset(result, location);
+    _storage->read(location, bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&result), sizeof(header)));
+
+    // Legacy header ends before the version 1 fields, which are the data instead
+    if (!std::ranges::equal(result.version, HEADER_VERSION))
+    {
+        result.schema_hash = 0;
+        result.checksum_id = std::uint8_t(checksum_kind::CRC32);
+        bn::memclear(&result.version, sizeof(result.version));
+    }
+
     return result;
 }
 
+void sram_rw::write_header_at(const int location, const header& header_)
+{
+    _storage->write(location,
+                    bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(&header_), sizeof(header)));
+}
+
 bool sram_rw::validate_header(const header& header_) const
 {
     return std::ranges::equal(bn::span<const std::uint8_t>(_magic), bn::span(header_.magic)) &&
-           (ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header_.data_size) <= SRAM_SIZE);
+           (header_.checksum_id < std::uint8_t(checksum_kind::COUNT)) &&
+           (ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header_.data_size) <= unsigned(_storage->size()));
+}
+
+void sram_rw::ensure_valid_locations() const
+{
+    const int storage_size = _storage->size();
+    const int erase_block_size = _storage->erase_block_size();
+
+    BN_ASSERT(_location_0 >= 0 && _location_0 < storage_size - int(sizeof(header)), "Invalid location_0: ",
+              _location_0);
+    BN_ASSERT(_location_1 >= 0 && _location_1 < storage_size - int(sizeof(header)), "Invalid location_1: ",
+              _location_1);
+    BN_ASSERT(_location_0 % erase_block_size == 0, "location_0 not aligned to erase block: ", _location_0);
+    BN_ASSERT(_location_1 % erase_block_size == 0, "location_1 not aligned to erase block: ", _location_1);
 }
 
 void sram_rw::ensure_no_locations_overlap(int size) const
 {
+    // Erasing covers the whole erase blocks
+    const int erase_block_size = _storage->erase_block_size();
+    size = (size + erase_block_size - 1) / erase_block_size * erase_block_size;
+
     const int save_locations_distance = bn::abs(_location_0 - _location_1);
     BN_ASSERT(save_locations_distance >= size, "Save location overlaps (", save_locations_distance, " < ", size, ")");
+    BN_ASSERT(std::max(_location_0, _location_1) + size <= _storage->size(), "Save location out of storage (",
+              std::max(_location_0, _location_1) + size, " > ", _storage->size(), ")");
+}
+
+bool sram_rw::erase_location(int location, int size)
+{
+    const int erase_block_size = _storage->erase_block_size();
+    if (erase_block_size <= 1)
+        return false;
+
+    _storage->erase(location, (size + erase_block_size - 1) / erase_block_size * erase_block_size);
+    return true;
 }
 
 auto sram_rw::next_sequence() const -> std::uint8_t
@@ -68,28 +314,121 @@ void sram_rw::increase_next_sequence()
         _next_sequence = _next_sequence.value() + 1;
 }
 
-void sram_rw::write_header(bn::span<std::uint8_t> span, bit_stream_writer::size_type logical_bytes_length)
+auto sram_rw::next_location() const -> int
+{
+    return location_of(next_location_index());
+}
+
+auto sram_rw::next_location_index() const -> int
+{
+    return next_sequence() % 2;
+}
+
+auto sram_rw::location_of(int location_index) const -> int
+{
+    return (location_index == 0) ? _location_0 : _location_1;
+}
+
+auto sram_rw::recent_valid_index() const -> int
+{
+    const bool valid_0 = _location_states[0] == location_state::VALID;
+    const bool valid_1 = _location_states[1] == location_state::VALID;
+
+    if (valid_0 && valid_1)
+        return sequence_greater_than(_cached_headers[0].sequence, _cached_headers[1].sequence) ? 0 : 1;
+    else if (valid_0)
+        return 0;
+    else if (valid_1)
+        return 1;
+
+    return -1;
+}
+
+bool sram_rw::candidate_header(int location_index, header& header_)
+{
+    switch (_location_states[location_index])
+    {
+    case location_state::VALID:
+        header_ = _cached_headers[location_index];
+        return true;
+    case location_state::INVALID:
+        return false;
+    default:
+        header_ = read_header_at(location_of(location_index));
+        return validate_header(header_);
+    }
+}
+
+void sram_rw::invalidate_next_location_state()
+{
+    _location_states[next_location_index()] = location_state::INVALID;
+}
+
+void sram_rw::commit_next_location(const header& header_)
+{
+    const int index = next_location_index();
+    _location_states[index] = location_state::VALID;
+    _cached_headers[index] = header_;
+
+    increase_next_sequence();
+}
+
+auto sram_rw::max_blocks() const -> unsigned
+{
+    return (unsigned(_storage->size()) / 2 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+}
+
+auto sram_rw::block_crc32s_of(int location_index) -> std::uint32_t*
+{
+    if (!_block_crc32s)
+        _block_crc32s = new std::uint32_t[2 * max_blocks()];
+
+    return _block_crc32s + location_index * max_blocks();
+}
+
+void sram_rw::invalidate_next_location_blocks()
+{
+    _blocks_counts[next_location_index()] = 0;
+}
+
+auto sram_rw::make_header(bit_stream_writer::size_type logical_bytes_length, std::uint32_t schema_hash) const
+    -> header
 {
-    // Prepare the header (without crc32)
     header hdr;
+    hdr.checksum = 0;
     bn::memcpy(&hdr.magic, _magic, sizeof(hdr.magic));
     hdr.sequence = next_sequence();
     hdr.data_size = logical_bytes_length;
+    hdr.schema_hash = schema_hash;
+    hdr.checksum_id = std::uint8_t(_checksum_kind);
+    bn::memcpy(&hdr.version, HEADER_VERSION, sizeof(hdr.version));
+    return hdr;
+}
+
+void sram_rw::write_header(bn::span<std::uint8_t> span, bit_stream_writer::size_type logical_bytes_length,
+                           std::uint32_t schema_hash)
+{
+    // Prepare the header (without checksum)
+    header hdr = make_header(logical_bytes_length, schema_hash);
+
+    // Calculate checksum, which starts with the header itself
+    hdr.checksum = header_checksum(hdr).update(span.subspan(sizeof(header))).value();
 
     // Copy the header
-    bn::span<std::uint8_t> crc32_span(span.subspan(sizeof(std::uint32_t)));
-    bn::memcpy(crc32_span.data(), reinterpret_cast<std::uint8_t*>(&hdr) + sizeof(std::uint32_t),
-               sizeof(header) - sizeof(std::uint32_t));
+    bn::memcpy(span.data(), &hdr, sizeof(header));
+}
 
-    // Write crc32 checksum
-    const std::uint32_t crc32 = crc32_fast(crc32_span.data(), crc32_span.size_bytes());
-    bn::memcpy(span.data(), &crc32, sizeof(std::uint32_t));
+auto sram_rw::header_checksum(const header& header_) -> checksum_stream
+{
+    checksum_stream result(checksum_kind(header_.checksum_id));
+    result.update(reinterpret_cast<const std::uint8_t*>(&header_) + sizeof(std::uint32_t),
+                  header_size(header_) - sizeof(std::uint32_t));
+    return result;
 }
 
-bool sram_rw::sequence_greater_than(std::uint8_t a, std::uint8_t b)
+auto sram_rw::header_size(const header& header_) -> unsigned
 {
-    return ((a > b) && (a - b <= std::numeric_limits<std::uint8_t>::max() / 2)) ||
-           ((a < b) && (b - a > std::numeric_limits<std::uint8_t>::max() / 2));
+    return std::ranges::equal(header_.version, HEADER_VERSION) ? sizeof(header) : LEGACY_HEADER_SIZE;
 }
 
 } // namespace ibn
@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_sram_wear_leveled_rw.h"
+
+#include "ibn_crc32.h"
+
+#include <bn_cstring.h>
+
+#include <algorithm>
+
+namespace ibn
+{
+
+sram_wear_leveled_rw::sram_wear_leveled_rw(bn::string_view magic, unsigned location, unsigned sector_size,
+                                           int sectors_count, storage& storage_)
+    : _storage(&storage_), _location(location), _sector_size(sector_size), _sectors_count(sectors_count)
+{
+    // Allow ending with '\0' case with `MAGIC_LEN + 1` for convenience
+    BN_ASSERT(magic.size() == MAGIC_LEN || magic.size() == MAGIC_LEN + 1, "Invalid magic length: ", magic.size(),
+              " (must be ", MAGIC_LEN, ")");
+    BN_ASSERT(sectors_count >= 2 && sectors_count <= MAX_SECTORS, "Invalid sectors_count: ", sectors_count);
+
+    const unsigned erase_block_size = _storage->erase_block_size();
+    BN_ASSERT(location % erase_block_size == 0, "location not aligned to erase block: ", location);
+    BN_ASSERT(sector_size % erase_block_size == 0 && sector_size % sizeof(bit_stream_writer::word_type) == 0,
+              "Invalid sector_size: ", sector_size);
+    BN_ASSERT(sector_size > sizeof(sector_header) + sizeof(record_header), "sector_size too small: ", sector_size);
+    BN_ASSERT(location + sector_size * sectors_count <= unsigned(_storage->size()), "Sectors out of storage (",
+              location + sector_size * sectors_count, " > ", _storage->size(), ")");
+
+    bn::memcpy(_magic, magic.data(), sizeof(_magic));
+}
+
+auto sram_wear_leveled_rw::erase_count(int sector) -> unsigned
+{
+    BN_ASSERT(sector >= 0 && sector < _sectors_count, "Invalid sector: ", sector);
+
+    scan();
+    return _erase_counts[sector];
+}
+
+sram_wear_leveled_rw::record_sink::record_sink(storage& storage_, int location, std::uint32_t crc32)
+    : _storage(&storage_), _location(location), _crc32(checksum_stream::crc32(crc32))
+{
+}
+
+void sram_wear_leveled_rw::record_sink::consume(bn::span<const bit_stream_writer::word_type> words)
+{
+    bn::span<const std::uint8_t> bytes(reinterpret_cast<const std::uint8_t*>(words.data()), words.size_bytes());
+
+    _crc32.update(bytes);
+    _storage->write(_location, bytes);
+
+    _location += bytes.size_bytes();
+}
+
+sram_wear_leveled_rw::record_source::record_source(storage& storage_, int location, unsigned words_count)
+    : _storage(&storage_), _location(location), _words_count(words_count)
+{
+}
+
+void sram_wear_leveled_rw::record_source::fetch(bit_stream_reader::size_type first_word_index,
+                                                bn::span<bit_stream_reader::word_type> words)
+{
+    if (unsigned(first_word_index) >= _words_count)
+        return;
+
+    const unsigned count = std::min(unsigned(words.size()), _words_count - unsigned(first_word_index));
+    _storage->read(_location + first_word_index * sizeof(bit_stream_reader::word_type),
+                   bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(words.data()),
+                                          count * sizeof(bit_stream_reader::word_type)));
+}
+
+void sram_wear_leveled_rw::scan()
+{
+    if (_scanned)
+        return;
+
+    _scanned = true;
+
+    for (int sector = 0; sector < _sectors_count; ++sector)
+        scan_sector(sector);
+
+    // Sectors that lost their erase counts are assumed to be erased the most
+    unsigned max_erase_count = 0;
+    for (int sector = 0; sector < _sectors_count; ++sector)
+        if (_erase_count_valid[sector])
+            max_erase_count = std::max(max_erase_count, _erase_counts[sector]);
+
+    for (int sector = 0; sector < _sectors_count; ++sector)
+        if (!_erase_count_valid[sector])
+            _erase_counts[sector] = max_erase_count;
+
+    // A torn record leaves programmed bytes after the recent record, which can't be written again without erasing
+    if (_current_sector >= 0 && _storage->erase_block_size() > 1 &&
+        !erased(_append_location, sector_location(_current_sector + 1)))
+        _append_location = sector_location(_current_sector + 1);
+}
+
+void sram_wear_leveled_rw::scan_sector(int sector)
+{
+    const int location = sector_location(sector);
+
+    sector_header sector_hdr;
+    _storage->read(location, bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&sector_hdr), sizeof(sector_hdr)));
+
+    if (sector_hdr.crc32 != sector_header_crc32(sector_hdr) ||
+        !std::ranges::equal(bn::span<const std::uint8_t>(_magic), bn::span(sector_hdr.magic)))
+        return;
+
+    _erase_counts[sector] = sector_hdr.erase_count;
+    _erase_count_valid[sector] = true;
+
+    // Walk the records until the first invalid one, or the one not following the previous one
+    // (which is a stale record on a storage without erasing)
+    const int sector_end = location + _sector_size;
+    int record_location = location + sizeof(sector_header);
+    bool has_prev = false;
+    std::uint32_t prev_sequence = 0;
+
+    while (record_location + int(sizeof(record_header)) <= sector_end)
+    {
+        record_header header;
+        _storage->read(record_location,
+                       bn::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(&header), sizeof(header)));
+
+        const int record_size =
+            sizeof(record_header) + ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header.data_size);
+        if (record_location + record_size > sector_end || (has_prev && header.sequence != prev_sequence + 1) ||
+            !validate_record(record_location, header))
+            break;
+
+        if (_recent_location < 0 || header.sequence > _recent_sequence)
+        {
+            _recent_location = record_location;
+            _recent_sequence = header.sequence;
+            _recent_data_size = header.data_size;
+            _current_sector = sector;
+            _append_location = record_location + record_size;
+        }
+
+        has_prev = true;
+        prev_sequence = header.sequence;
+        record_location += record_size;
+    }
+}
+
+bool sram_wear_leveled_rw::validate_record(int location, const record_header& header) const
+{
+    const int data_location = location + sizeof(record_header);
+    const unsigned ceiled_data_size = ceil_to_multiple_of<sizeof(bit_stream_reader::word_type)>(header.data_size);
+
+    checksum_stream crc32 = checksum_stream::crc32(record_header_crc32(header));
+
+    // Read the data chunk by chunk
+    bit_stream_reader::word_type chunk[STREAM_CHUNK_WORDS];
+    for (unsigned offset = 0; offset < ceiled_data_size; offset += sizeof(chunk))
+    {
+        const unsigned chunk_size = std::min(unsigned(sizeof(chunk)), ceiled_data_size - offset);
+        bn::span<std::uint8_t> chunk_span(reinterpret_cast<std::uint8_t*>(chunk), chunk_size);
+        _storage->read(data_location + offset, chunk_span);
+
+        crc32.update(chunk_span);
+    }
+
+    return crc32.value() == header.crc32;
+}
+
+bool sram_wear_leveled_rw::erased(int location, int end) const
+{
+    std::uint8_t chunk[IBN_CFG_SRAM_RW_STREAM_CHUNK_SIZE];
+    for (; location < end; location += sizeof(chunk))
+    {
+        bn::span<std::uint8_t> chunk_span(chunk, std::min(int(sizeof(chunk)), end - location));
+        _storage->read(location, chunk_span);
+
+        if (!std::ranges::all_of(chunk_span, [](std::uint8_t byte) { return byte == 0xFF; }))
+            return false;
+    }
+
+    return true;
+}
+
+auto sram_wear_leveled_rw::prepare_record_location(unsigned record_size) -> int
+{
+    scan();
+
+    // Append to the current sector if it fits, otherwise move to the next sector
+    if (_current_sector >= 0 && _append_location + record_size <= unsigned(sector_location(_current_sector + 1)))
+        return _append_location;
+
+    const int sector = next_sector();
+    erase_sector(sector);
+
+    _current_sector = sector;
+    _append_location = sector_location(sector) + sizeof(sector_header);
+    return _append_location;
+}
+
+auto sram_wear_leveled_rw::next_sector() const -> int
+{
+    // Ties go to the next sector in order, so the sectors are rotated if evenly erased
+    int result = -1;
+    for (int offset = 1; offset <= _sectors_count; ++offset)
+    {
+        const int sector = (_current_sector + offset) % _sectors_count;
+        if (sector == _current_sector)
+            continue;
+
+        if (result < 0 || _erase_counts[sector] < _erase_counts[result])
+            result = sector;
+    }
+
+    return result;
+}
+
+void sram_wear_leveled_rw::erase_sector(int sector)
+{
+    const int location = sector_location(sector);
+    _storage->erase(location, _sector_size);
+
+    ++_erase_counts[sector];
+    _erase_count_valid[sector] = true;
+
+    sector_header sector_hdr = {};
+    sector_hdr.erase_count = _erase_counts[sector];
+    bn::memcpy(sector_hdr.magic, _magic, sizeof(sector_hdr.magic));
+    sector_hdr.crc32 = sector_header_crc32(sector_hdr);
+
+    _storage->write(location, bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(&sector_hdr),
+                                                           sizeof(sector_hdr)));
+}
+
+auto sram_wear_leveled_rw::make_record_header(unsigned data_size) const -> record_header
+{
+    record_header header = {};
+    header.sequence = (_recent_location < 0) ? 0 : _recent_sequence + 1;
+    header.data_size = data_size;
+    return header;
+}
+
+void sram_wear_leveled_rw::commit_record(int location, const record_header& header)
+{
+    _storage->write(location,
+                    bn::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(&header), sizeof(header)));
+
+    _recent_location = location;
+    _recent_sequence = header.sequence;
+    _recent_data_size = header.data_size;
+    _append_location = location + sizeof(record_header) +
+                       ceil_to_multiple_of<sizeof(bit_stream_writer::word_type)>(unsigned(header.data_size));
+}
+
+auto sram_wear_leveled_rw::sector_location(int sector) const -> int
+{
+    return _location + sector * _sector_size;
+}
+
+auto sram_wear_leveled_rw::sector_header_crc32(const sector_header& header) -> std::uint32_t
+{
+    return crc32_fast(reinterpret_cast<const std::uint8_t*>(&header) + sizeof(std::uint32_t),
+                      sizeof(sector_header) - sizeof(std::uint32_t));
+}
+
+auto sram_wear_leveled_rw::record_header_crc32(const record_header& header) -> std::uint32_t
+{
+    return crc32_fast(reinterpret_cast<const std::uint8_t*>(&header) + sizeof(std::uint32_t),
+                      sizeof(record_header) - sizeof(std::uint32_t));
+}
+
+} // namespace ibn
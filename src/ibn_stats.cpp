@@ -13,6 +13,12 @@
 #include <bn_sprite_tiles.h>
 #include <bn_sprites.h>
 
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+#include <bn_timers.h>
+
+#include <cstddef>
+#endif
+
 #if IBN_CFG_STATS_ENABLED
 
 namespace ibn
@@ -38,6 +44,43 @@ void stats::update_iw()
         _max_used_iw = cur_iw;
 }
 
+#if IBN_CFG_SRAM_RW_STATS_ENABLED
+
+stats::sram_rw_phase_timer::sram_rw_phase_timer(sram_rw_phase phase)
+    : _nested_ticks_at_start(stats::instance()._sram_rw_nested_ticks), _phase(phase)
+{
+}
+
+stats::sram_rw_phase_timer::~sram_rw_phase_timer()
+{
+    const int ticks = _timer.elapsed_ticks();
+
+    stats& inst = stats::instance();
+    const int nested_ticks = inst._sram_rw_nested_ticks - _nested_ticks_at_start;
+    inst.add_sram_rw_ticks(_phase, ticks - nested_ticks);
+    inst._sram_rw_nested_ticks = _nested_ticks_at_start + ticks;
+}
+
+void stats::reset_sram_rw_cycles()
+{
+    // `tools/ibn_stats.lua` reads the cycles of each phase at these offsets
+    static_assert(offsetof(stats, _sram_rw_cycles) == 24 && sizeof(_sram_rw_cycles) == 4 * 4,
+                  "Update the sram_rw offsets in tools/ibn_stats.lua");
+
+    for (volatile std::uint32_t& cycles : _sram_rw_cycles)
+        cycles = 0;
+}
+
+void stats::add_sram_rw_ticks(sram_rw_phase phase, int ticks)
+{
+    constexpr int CYCLES_PER_FRAME = 280896;
+
+    const auto cycles = std::uint32_t((std::int64_t(ticks) * CYCLES_PER_FRAME) / bn::timers::ticks_per_frame());
+    _sram_rw_cycles[int(phase)] = _sram_rw_cycles[int(phase)] + cycles;
+}
+
+#endif
+
 } // namespace ibn
 
 #endif // IBN_CFG_STATS_ENABLED
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_storage.h"
+
+#include <bn_assert.h>
+#include <bn_cstring.h>
+#include <bn_sram.h>
+
+namespace ibn
+{
+
+auto sram_storage::instance() -> sram_storage&
+{
+    static sram_storage result;
+    return result;
+}
+
+auto sram_storage::size() const -> int
+{
+    return bn::sram::size();
+}
+
+auto sram_storage::erase_block_size() const -> int
+{
+    return 1;
+}
+
+void sram_storage::read(int offset, bn::span<std::uint8_t> bytes)
+{
+    bn::sram::read_span_offset(bytes, offset);
+}
+
+void sram_storage::write(int offset, bn::span<const std::uint8_t> bytes)
+{
+    bn::sram::write_span_offset(bytes, offset);
+}
+
+void sram_storage::erase(int, int)
+{
+    // SRAM can be overwritten without erasing
+}
+
+memory_storage::memory_storage(bn::span<std::uint8_t> memory, int erase_block_size)
+    : _memory(memory), _erase_block_size(erase_block_size)
+{
+    BN_ASSERT(erase_block_size > 0, "Invalid erase_block_size: ", erase_block_size);
+    BN_ASSERT(memory.size() % erase_block_size == 0, "Memory size is not a multiple of erase_block_size: ",
+              memory.size());
+}
+
+auto memory_storage::size() const -> int
+{
+    return _memory.size();
+}
+
+auto memory_storage::erase_block_size() const -> int
+{
+    return _erase_block_size;
+}
+
+void memory_storage::read(int offset, bn::span<std::uint8_t> bytes)
+{
+    BN_ASSERT(offset >= 0 && offset + bytes.size() <= _memory.size(), "Invalid read: ", bytes.size(), " bytes at ",
+              offset);
+
+    bn::memcpy(bytes.data(), _memory.data() + offset, bytes.size());
+}
+
+void memory_storage::write(int offset, bn::span<const std::uint8_t> bytes)
+{
+    BN_ASSERT(offset >= 0 && offset + bytes.size() <= _memory.size(), "Invalid write: ", bytes.size(), " bytes at ",
+              offset);
+
+    if (_erase_block_size == 1)
+    {
+        bn::memcpy(_memory.data() + offset, bytes.data(), bytes.size());
+        return;
+    }
+
+    // Flash can only clear bits, so writing without erasing corrupts the data
+    for (int index = 0; index < bytes.size(); ++index)
+        _memory[offset + index] &= bytes[index];
+}
+
+void memory_storage::erase(int offset, int size)
+{
+    BN_ASSERT(offset % _erase_block_size == 0 && size % _erase_block_size == 0, "Unaligned erase: ", size,
+              " bytes at ", offset);
+    BN_ASSERT(offset >= 0 && offset + size <= _memory.size(), "Invalid erase: ", size, " bytes at ", offset);
+
+    if (_erase_block_size == 1)
+        return;
+
+    bn::memset(_memory.data() + offset, 0xFF, size);
+    _erased_blocks_count += size / _erase_block_size;
+}
+
+} // namespace ibn
@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: Copyright 2021-2025 Guyeon Yu <copyrat90@gmail.com>
+// SPDX-License-Identifier: Zlib
+
+#include "ibn_task_scheduler.h"
+
+#include <bn_assert.h>
+#include <bn_timer.h>
+
+#include <limits>
+#include <utility>
+
+namespace ibn
+{
+
+namespace
+{
+
+task_scheduler* current_scheduler = nullptr;
+
+} // namespace
+
+task_scheduler::task_scheduler(int max_tasks, int priorities_count)
+    : _max_tasks(max_tasks), _priorities_count(priorities_count)
+{
+    BN_ASSERT(max_tasks > 0 && max_tasks <= std::numeric_limits<std::int16_t>::max(), "Invalid max_tasks: ",
+              max_tasks);
+    BN_ASSERT(priorities_count > 0 && priorities_count <= std::numeric_limits<std::uint8_t>::max() + 1,
+              "Invalid priorities_count: ", priorities_count);
+
+    _slots = new slot[max_tasks];
+    _ready_queues = new bn::intrusive_list<slot>[priorities_count];
+    _sleeping_slots = new timer_wheel<slot>(_frame);
+
+    for (int index = 0; index < max_tasks; ++index)
+        _free_slots.push_back(_slots[index]);
+}
+
+task_scheduler::~task_scheduler()
+{
+    for (int index = 0; index < _max_tasks; ++index)
+        if (_slots[index].state != slot_state::FREE)
+            _slots[index].handle.destroy();
+
+    // Unlink the slots before deleting them
+    delete[] _ready_queues;
+    delete _sleeping_slots;
+    _free_slots.clear();
+    _waiting_slots.clear();
+    delete[] _slots;
+}
+
+void task_scheduler::cancel(task_id id)
+{
+    slot* slot_ = slot_of(id);
+    if (!slot_)
+        return;
+
+    if (slot_ == _running)
+    {
+        slot_->cancelled = true;
+        return;
+    }
+
+    unlink(*slot_);
+    free_slot(*slot_);
+}
+
+bool task_scheduler::contains(task_id id) const
+{
+    return slot_of(id) != nullptr;
+}
+
+void task_scheduler::update()
+{
+    bn::timer timer;
+    _last_deferred_count = 0;
+    ++_frame;
+
+    wake_sleeping_slots();
+    poll_waiting_slots();
+
+    for (int priority = 0; priority < _priorities_count; ++priority)
+    {
+        bn::intrusive_list<slot>& queue = _ready_queues[priority];
+        if (queue.empty())
+            continue;
+
+        // Tasks queued while resuming (including the resumed ones) wait for the next update, behind the end marker.
+        // (Not the count of the queue, which goes stale if a task cancels the others in the queue.)
+        slot end_marker;
+        queue.push_back(end_marker);
+
+        while (&queue.front() != &end_marker)
+        {
+            if (priority != 0 && _frame_budget_ticks > 0 && timer.elapsed_ticks() >= _frame_budget_ticks)
+            {
+                // Defer the rest, which stay in front of their queues
+                for (auto it = queue.begin(); &*it != &end_marker; ++it)
+                    ++_last_deferred_count;
+                for (int lower = priority + 1; lower < _priorities_count; ++lower)
+                    _last_deferred_count += _ready_queues[lower].size();
+
+                queue.erase(end_marker);
+                return;
+            }
+
+            slot& slot_ = queue.front();
+            queue.pop_front();
+            resume(slot_);
+        }
+
+        queue.erase(end_marker);
+    }
+}
+
+auto task_scheduler::current() -> task_scheduler*
+{
+    return current_scheduler;
+}
+
+void task_scheduler::set_frame_budget_ticks(int ticks)
+{
+    BN_ASSERT(ticks >= 0, "Invalid frame budget ticks: ", ticks);
+
+    _frame_budget_ticks = ticks;
+}
+
+auto task_scheduler::spawn_handle(std::coroutine_handle<void> handle, int priority) -> task_id
+{
+    BN_ASSERT(priority >= 0 && priority < _priorities_count, "Invalid priority: ", priority);
+
+    // Eager task might be completed already
+    if (handle.done())
+    {
+        handle.destroy();
+        return task_id();
+    }
+
+    BN_ASSERT(!_free_slots.empty(), "No more tasks available: ", _max_tasks);
+
+    slot& slot_ = _free_slots.front();
+    _free_slots.pop_front();
+
+    slot_.handle = handle;
+    slot_.resume_point = handle;
+    slot_.priority = std::uint8_t(priority);
+    slot_.state = slot_state::READY;
+    slot_.cancelled = false;
+    _ready_queues[priority].push_back(slot_);
+
+    return task_id(int(&slot_ - _slots), slot_.generation);
+}
+
+auto task_scheduler::slot_of(task_id id) const -> slot*
+{
+    if (id._index < 0 || id._index >= _max_tasks)
+        return nullptr;
+
+    slot& slot_ = _slots[id._index];
+    if (slot_.state == slot_state::FREE || slot_.cancelled || slot_.generation != id._generation)
+        return nullptr;
+
+    return &slot_;
+}
+
+void task_scheduler::resume(slot& slot_)
+{
+    // Ready on the next frame, unless it suspends with the awaitables
+    const std::coroutine_handle<void> resume_point = std::exchange(slot_.resume_point, slot_.handle);
+    slot_.state = slot_state::READY;
+
+    task_scheduler* const prev_scheduler = std::exchange(current_scheduler, this);
+    _running = &slot_;
+    resume_point.resume();
+    _running = nullptr;
+    current_scheduler = prev_scheduler;
+
+    if (slot_.handle.done() || slot_.cancelled)
+        free_slot(slot_);
+    else if (slot_.state == slot_state::SLEEPING)
+        sleep(slot_);
+    else if (slot_.state == slot_state::WAITING)
+        _waiting_slots.push_back(slot_);
+    else
+        _ready_queues[slot_.priority].push_back(slot_);
+}
+
+void task_scheduler::free_slot(slot& slot_)
+{
+    slot_.handle.destroy();
+    slot_.handle = nullptr;
+    slot_.resume_point = nullptr;
+    slot_.state = slot_state::FREE;
+    ++slot_.generation;
+
+    _free_slots.push_back(slot_);
+}
+
+void task_scheduler::wake_sleeping_slots()
+{
+    // Advances along with `_frame`
+    _sleeping_slots->advance([this](slot& slot_) { make_ready(slot_); });
+}
+
+void task_scheduler::poll_waiting_slots()
+{
+    // Safe iteration (ready ones are moved to the ready queues)
+    auto cur = _waiting_slots.begin();
+    while (cur != _waiting_slots.end())
+    {
+        auto next = cur;
+        ++next;
+
+        slot& slot_ = *cur;
+        if (slot_.poll(slot_.poll_object))
+        {
+            _waiting_slots.erase(slot_);
+            make_ready(slot_);
+        }
+
+        cur = next;
+    }
+}
+
+void task_scheduler::sleep(slot& slot_)
+{
+    _sleeping_slots->add(slot_, slot_.wake_frame);
+}
+
+void task_scheduler::make_ready(slot& slot_)
+{
+    slot_.state = slot_state::READY;
+    _ready_queues[slot_.priority].push_back(slot_);
+}
+
+void task_scheduler::unlink(slot& slot_)
+{
+    switch (slot_.state)
+    {
+    case slot_state::SLEEPING:
+        _sleeping_slots->remove(slot_);
+        break;
+    case slot_state::WAITING:
+        _waiting_slots.erase(slot_);
+        break;
+    case slot_state::READY:
+        _ready_queues[slot_.priority].erase(slot_);
+        break;
+    default:
+        break;
+    }
+}
+
+auto task_scheduler::running_slot() -> slot&
+{
+    BN_ASSERT(current_scheduler && current_scheduler->_running, "Not in a task resumed by task_scheduler");
+
+    return *current_scheduler->_running;
+}
+
+} // namespace ibn
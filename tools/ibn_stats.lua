@@ -6,6 +6,9 @@
 
 reset_max_cpu_period = 30
 
+-- Set this to true if `IBN_CFG_SRAM_RW_STATS_ENABLED` is true in your C++ sources.
+show_sram_rw_stats = false
+
 last_max_cpu = 0
 cur_max_cpu = 0
 reset_max_cpu_counter = reset_max_cpu_period
@@ -86,6 +89,16 @@ function print_stats()
         emu.drawString(0, 8 * 9,
             string.format("spr_pals: %d/%d (%.0f%%)", used_sprite_palettes, 256, used_sprite_palettes / 256 * 100),
             text_color, bg_color)
+
+        if show_sram_rw_stats then
+            -- `_sram_rw_cycles[sram_rw_phase::COUNT]`: measure (+24), serialize (+28), checksum (+32), storage (+36)
+            local sram_rw_phases = { "measure", "serialize", "checksum", "storage" }
+            for i, phase in ipairs(sram_rw_phases) do
+                local cycles = emu.read32(stats.address + 20 + i * 4, stats.memType, false)
+                emu.drawString(0, (8 + i) * 9, string.format("sram %s: %d cycles", phase, cycles), text_color,
+                    bg_color)
+            end
+        end
     else
         emu.drawString(0, 0, "`ibn::stats` not found!", text_color, bg_color)
     end